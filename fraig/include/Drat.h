@@ -0,0 +1 @@
+../src/sat/Drat.h
\ No newline at end of file
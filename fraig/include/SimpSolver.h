@@ -0,0 +1 @@
+../src/sat/SimpSolver.h
\ No newline at end of file
@@ -1,36 +1,103 @@
-cirGate.o: cirGate.cpp cirGate.h cirDef.h ../../include/myHashMap.h \
- ../../include/sat.h ../../include/Solver.h ../../include/SolverTypes.h \
+cirAig.o: cirAig.cpp cirAig.h cirDef.h ../../include/myHashMap.h
+cirCec.o: cirCec.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
  ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
- ../../include/Proof.h ../../include/File.h cirMgr.h ../../include/util.h \
- ../../include/rnGen.h ../../include/myUsage.h
-cirSim.o: cirSim.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
- cirGate.h ../../include/sat.h ../../include/Solver.h \
- ../../include/SolverTypes.h ../../include/Global.h \
- ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
- ../../include/File.h ../../include/util.h ../../include/rnGen.h \
- ../../include/myUsage.h
-cirMgr.o: cirMgr.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
- cirGate.h ../../include/sat.h ../../include/Solver.h \
- ../../include/SolverTypes.h ../../include/Global.h \
- ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
- ../../include/File.h ../../include/util.h ../../include/rnGen.h \
- ../../include/myUsage.h
-cirFraig.o: cirFraig.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
- cirGate.h ../../include/sat.h ../../include/Solver.h \
- ../../include/SolverTypes.h ../../include/Global.h \
- ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
- ../../include/File.h cirFraig.h ../../include/util.h \
- ../../include/rnGen.h ../../include/myUsage.h
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
 cirCmd.o: cirCmd.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
- cirGate.h ../../include/sat.h ../../include/Solver.h \
- ../../include/SolverTypes.h ../../include/Global.h \
- ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
- ../../include/File.h cirCmd.h ../../include/cmdParser.h \
- ../../include/cmdCharDef.h ../../include/util.h ../../include/rnGen.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h cirCmd.h \
+ ../../include/cmdParser.h ../../include/cmdCharDef.h cirGen.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
+cirCone.o: cirCone.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h
+cirCut.o: cirCut.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h cirCut.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
+cirFraig.o: cirFraig.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h cirFraig.h \
+ cirCut.h ../../include/util.h ../../include/rnGen.h \
  ../../include/myUsage.h
-cirOpt.o: cirOpt.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
- cirGate.h ../../include/sat.h ../../include/Solver.h \
+cirGate.o: cirGate.cpp cirGate.h cirDef.h ../../include/myHashMap.h \
+ ../../include/sat.h ../../include/SimpSolver.h ../../include/Solver.h \
  ../../include/SolverTypes.h ../../include/Global.h \
  ../../include/VarOrder.h ../../include/Heap.h ../../include/Proof.h \
- ../../include/File.h ../../include/util.h ../../include/rnGen.h \
+ ../../include/File.h ../../include/Drat.h cirMgr.h cirSim.h cirPattern.h \
+ cirProfile.h cirAig.h ../../include/rnGen.h ../../include/util.h \
+ ../../include/rnGen.h ../../include/myUsage.h
+cirGen.o: cirGen.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h cirGen.h
+cirGuide.o: cirGuide.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h cirGuide.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
+cirMgr.o: cirMgr.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
+cirOdc.o: cirOdc.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h cirOdc.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
+cirOpt.o: cirOpt.cpp cirDef.h ../../include/myHashMap.h cirMgr.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
+cirPattern.o: cirPattern.cpp cirPattern.h cirDef.h \
+ ../../include/myHashMap.h
+cirProfile.o: cirProfile.cpp cirProfile.h
+cirRewrite.o: cirRewrite.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h cirRewrite.h \
+ cirCut.h ../../include/util.h ../../include/rnGen.h \
  ../../include/myUsage.h
+cirSig.o: cirSig.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
+cirSim.o: cirSim.cpp cirMgr.h cirDef.h ../../include/myHashMap.h \
+ cirGate.h ../../include/sat.h ../../include/SimpSolver.h \
+ ../../include/Solver.h ../../include/SolverTypes.h \
+ ../../include/Global.h ../../include/VarOrder.h ../../include/Heap.h \
+ ../../include/Proof.h ../../include/File.h ../../include/Drat.h cirSim.h \
+ cirPattern.h cirProfile.h cirAig.h ../../include/rnGen.h \
+ ../../include/util.h ../../include/rnGen.h ../../include/myUsage.h
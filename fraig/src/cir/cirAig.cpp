@@ -0,0 +1,130 @@
+/****************************************************************************
+  FileName     [ cirAig.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the compact literal-based AIG core ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <algorithm>
+#include <cassert>
+#include "cirAig.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+
+/************************************/
+/*   class CirAig member functions  */
+/************************************/
+void
+CirAig::clear()
+{
+   _inputs = 0;
+   _fanins.assign(2, 0);   // the constant
+   _outputs.clear();
+   _foStart.clear();
+   _foList.clear();
+   _levels.clear();
+}
+
+// the inputs must come before the ANDs
+unsigned
+CirAig::addInput()
+{
+   assert(getNodeCount() == _inputs + 1);
+   _inputs++;
+   _fanins.push_back(0);
+   _fanins.push_back(0);
+   _foStart.clear();
+   _levels.clear();
+   return 2 * _inputs;
+}
+
+unsigned
+CirAig::addAnd(unsigned lit0, unsigned lit1)
+{
+   unsigned n = getNodeCount();
+   assert((lit0 >> 1) < n && (lit1 >> 1) < n);
+   _fanins.push_back(lit0);
+   _fanins.push_back(lit1);
+   _foStart.clear();
+   _levels.clear();
+   return 2 * n;
+}
+
+// the #ANDs on the longest path to an output
+unsigned
+CirAig::getDepth() const
+{
+   buildLevels();
+   unsigned depth = 0;
+   for (size_t i = 0, n = _outputs.size(); i < n; i++)
+      depth = std::max(depth, _levels[_outputs[i] >> 1]);
+   return depth;
+}
+
+void
+CirAig::simulate(vector<CirSimData>& values) const
+{
+   assert(values.size() >= getNodeCount());
+   values[0] = 0;
+   const unsigned* f = &_fanins[0];
+   CirSimData* v = &values[0];
+   for (unsigned n = _inputs + 1, e = getNodeCount(); n < e; n++) {
+      unsigned a = f[2 * n], b = f[2 * n + 1];
+      v[n] = (v[a >> 1] ^ -(CirSimData)(a & 1)) & (v[b >> 1] ^ -(CirSimData)(b & 1));
+   }
+}
+
+// in bytes, with the side tables made so far
+size_t
+CirAig::getMemSize() const
+{
+   return (_fanins.capacity() + _outputs.capacity() + _foStart.capacity()
+           + _foList.capacity() + _levels.capacity()) * sizeof(unsigned);
+}
+
+/*****************************************/
+/*   Private member functions of CirAig  */
+/*****************************************/
+// by counting sort on the fanin nodes; the fanouts of a node are then in
+// node order
+void
+CirAig::buildFanouts() const
+{
+   if (!_foStart.empty()) return;
+   unsigned nNodes = getNodeCount();
+   _foStart.assign(nNodes + 1, 0);
+   for (unsigned n = _inputs + 1; n < nNodes; n++) {
+      _foStart[(_fanins[2 * n] >> 1) + 1]++;
+      _foStart[(_fanins[2 * n + 1] >> 1) + 1]++;
+   }
+   for (unsigned n = 0; n < nNodes; n++)
+      _foStart[n + 1] += _foStart[n];
+
+   _foList.resize(_foStart[nNodes]);
+   IdList fill(_foStart.begin(), _foStart.end() - 1);
+   for (unsigned n = _inputs + 1; n < nNodes; n++)
+      for (unsigned j = 0; j < 2; j++) {
+         unsigned f = _fanins[2 * n + j];
+         _foList[fill[f >> 1]++] = 2 * n + (f & 1);
+      }
+}
+
+void
+CirAig::buildLevels() const
+{
+   if (!_levels.empty()) return;
+   unsigned nNodes = getNodeCount();
+   _levels.assign(nNodes, 0);
+   for (unsigned n = _inputs + 1; n < nNodes; n++)
+      _levels[n] = std::max(_levels[_fanins[2 * n] >> 1],
+                            _levels[_fanins[2 * n + 1] >> 1]) + 1;
+}
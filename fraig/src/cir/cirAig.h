@@ -0,0 +1,87 @@
+/****************************************************************************
+  FileName     [ cirAig.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the compact literal-based AIG core ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_AIG_H
+#define CIR_AIG_H
+
+#include <vector>
+#include <cassert>
+#include "cirDef.h"
+
+using namespace std;
+
+//------------------------------------------------------------------------
+//   AIG nodes as pairs of 32-bit literals in a flat array
+//------------------------------------------------------------------------
+// Node 0 is the constant, nodes 1 .. _inputs are the inputs, and the ANDs
+// follow in topological order, so a single pass in node order evaluates
+// the whole circuit. A literal is 2 * node + inverted. Only the fanins are
+// kept (8 bytes per node); the fanouts and the levels are side tables made
+// on demand, and anything else about a node (name, line number, ID) is
+// looked up by whoever built the core, e.g. CirMgr through its gate view.
+// It does not replace the gates: CirMgr makes it again from the DFS list
+// as an extra read-only view for the passes that scan the circuit in node
+// order (strash hashing, simulation, ODC, depth), which still make their
+// changes on the gates; it adds to the memory of the gates.
+class CirAig
+{
+public:
+   CirAig(): _inputs(0) { clear(); }
+   ~CirAig() {}
+
+   void clear();
+   unsigned addInput();
+   unsigned addAnd(unsigned lit0, unsigned lit1);
+   void addOutput(unsigned lit) { _outputs.push_back(lit); }
+   void reserve(size_t nodes) { _fanins.reserve(2 * nodes); }
+
+   unsigned getNodeCount() const { return _fanins.size() / 2; }
+   unsigned getInputCount() const { return _inputs; }
+   unsigned getAndCount() const { return getNodeCount() - _inputs - 1; }
+   unsigned getOutputCount() const { return _outputs.size(); }
+   bool isAnd(unsigned n) const { return n > _inputs; }
+   unsigned getFanin0(unsigned n) const { return _fanins[2 * n]; }
+   unsigned getFanin1(unsigned n) const { return _fanins[2 * n + 1]; }
+   unsigned getOutput(size_t i) const { return _outputs[i]; }
+
+   // side tables; made by the first call after a change
+   unsigned getFanoutCount(unsigned n) const {
+      buildFanouts();
+      return _foStart[n + 1] - _foStart[n];
+   }
+   // the literal of the fanout node, inverted if the fanin is
+   unsigned getFanout(unsigned n, size_t i) const {
+      buildFanouts();
+      assert(_foStart[n] + i < _foStart[n + 1]);
+      return _foList[_foStart[n] + i];
+   }
+   unsigned getLevel(unsigned n) const { buildLevels(); return _levels[n]; }
+   unsigned getDepth() const;
+
+   // values[0 .. _inputs] are given; the ANDs are filled in
+   void simulate(vector<CirSimData>& values) const;
+   static CirSimData getValue(const vector<CirSimData>& values, unsigned lit) {
+      return values[lit >> 1] ^ -(CirSimData)(lit & 1);
+   }
+
+   size_t getMemSize() const;
+
+private:
+   unsigned           _inputs;
+   IdList             _fanins;     // 2 per node; 0 for the non-ANDs
+   IdList             _outputs;    // literals
+
+   mutable IdList     _foStart;    // by node, and one past the last
+   mutable IdList     _foList;
+   mutable IdList     _levels;
+
+   void buildFanouts() const;
+   void buildLevels() const;
+};
+
+#endif // CIR_AIG_H
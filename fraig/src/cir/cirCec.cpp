@@ -0,0 +1,255 @@
+/****************************************************************************
+  FileName     [ cirCec.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define combinational equivalence checking by a miter ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <cassert>
+#include "cirMgr.h"
+#include "cirGate.h"
+#include "util.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// the POs now driven by the constant, and not by an earlier phase, are
+// decided by this one; returns their count
+static unsigned markDecided(const GateList& pos, const CirGate* c,
+                            vector<const char*>& by, const char* phase)
+{
+   unsigned n = 0;
+   for (size_t i = 0, m = pos.size(); i < m; i++)
+      if (!by[i] && pos[i]->getFanin(0) == c) {
+         by[i] = phase;
+         n++;
+      }
+   return n;
+}
+
+// the index in l2 of the gate of the same name as each one in l1;
+// false unless the names pair them all one to one
+static bool pairByName(const GateList& l1, const GateList& l2, IdList& pair,
+                       const char* kind)
+{
+   map<string, unsigned> index;
+   for (size_t i = 0, n = l2.size(); i < n; i++)
+      if (l2[i]->_name.empty() || !index.insert(make_pair(l2[i]->_name, i)).second) {
+         cerr << "Error: " << kind << " " << i << " of the second circuit has no "
+              << "unique name!!" << endl;
+         return false;
+      }
+   pair.resize(l1.size());
+   for (size_t i = 0, n = l1.size(); i < n; i++) {
+      map<string, unsigned>::iterator it = index.find(l1[i]->_name);
+      if (l1[i]->_name.empty() || it == index.end()) {
+         cerr << "Error: " << kind << " " << i << " of the first circuit has no "
+              << "name in the second one!!" << endl;
+         return false;
+      }
+      pair[i] = it->second;
+      index.erase(it);
+   }
+   return true;
+}
+
+/*****************************************/
+/*   Public member functions of CirMgr   */
+/*****************************************/
+// The PIs and POs of b are paired with those of a by index, or else by
+// name; the POs of the miter are the XORs of the pairs, in the order of
+// a. The UNDEF gates of either circuit stay free inputs of their own.
+bool
+CirMgr::buildMiter(const CirMgr& a, const CirMgr& b, bool byName)
+{
+   size_t nPIs = a._piList.size(), nPOs = a._poList.size();
+   if (b._piList.size() != nPIs || b._poList.size() != nPOs) {
+      cerr << "Error: the circuits have " << nPIs << " PIs, " << nPOs
+           << " POs and " << b._piList.size() << " PIs, " << b._poList.size()
+           << " POs!!" << endl;
+      return false;
+   }
+   IdList piOf(nPIs), poOf(nPOs);
+   if (byName) {
+      if (!pairByName(a._piList, b._piList, piOf, "PI") ||
+          !pairByName(a._poList, b._poList, poOf, "PO"))
+         return false;
+   } else {
+      for (size_t i = 0; i < nPIs; i++) piOf[i] = i;
+      for (size_t i = 0; i < nPOs; i++) poOf[i] = i;
+   }
+
+   _maxNum = 0;
+   _latchCount = 0;
+   _andGateCount = 0;
+   _gates[0] = new ConstGate();
+   IdList litA(a._gates.rbegin()->first + 1, 0), litB(b._gates.rbegin()->first + 1, 0);
+   for (size_t i = 0; i < nPIs; i++) {
+      unsigned lit = 2 * ++_maxNum;
+      addPI(0, lit)->_name = a._piList[i]->_name;
+      litA[a._piList[i]->getID()] = lit;
+      litB[b._piList[piOf[i]]->getID()] = lit;
+   }
+   _inputCount = nPIs;
+   addMiterCone(a, litA);
+   addMiterCone(b, litB);
+
+   // x ^ y = !(!(x & !y) & !(!x & y))
+   IdList outs(nPOs);
+   for (size_t i = 0; i < nPOs; i++) {
+      const CirGate* pa = a._poList[i];
+      const CirGate* pb = b._poList[poOf[i]];
+      unsigned x = litA[pa->getFanin(0)->getID()] ^ pa->getInv(0);
+      unsigned y = litB[pb->getFanin(0)->getID()] ^ pb->getInv(0);
+      unsigned t1 = 2 * ++_maxNum, t2 = 2 * ++_maxNum, o = 2 * ++_maxNum;
+      addAIG(0, t1, x, y ^ 1);
+      addAIG(0, t2, x ^ 1, y);
+      addAIG(0, o, t1 ^ 1, t2 ^ 1);
+      _andGateCount += 3;
+      outs[i] = o ^ 1;
+   }
+   _outputCount = nPOs;
+   for (size_t i = 0; i < nPOs; i++)
+      addPO(0, outs[i])->_name = a._poList[i]->_name;
+
+   initialize();
+   return true;
+}
+
+// Prove every PO of a miter constant 0: strash, optimize, simulate and
+// fraig the whole of it, then decide the POs left one by one by SAT.
+// Each phase is timed, and a PO is decided by the first one that makes it
+// constant. Returns the #POs that are not constant 0.
+unsigned
+CirMgr::checkMiter()
+{
+   // Output Example:
+   // Miter: 2360 AIGs -> 1181 by strash, optimize and fraig in 0.52 s
+   //   strash  : 2360 -> 1975 AIGs, 0 outputs decided in 0.0100 s
+   //   optimize: 1975 -> 1902 AIGs, 4 outputs decided in 0.0020 s
+   //   fraig   : 1902 -> 1181 AIGs, 25 outputs decided in 0.5080 s
+   //   Output 0 (sum0): EQUAL by fraig
+   //   Output 1 (sum1): EQUAL by SAT in 0.0012 s
+   //   Output 2 (sum2): DIFFERENT by SAT in 0.0003 s
+   //     Counterexample: 0110...1 (the PIs in order)
+   //   SAT     : 3 outputs decided in 0.0015 s
+   // CEC: 31 of 32 outputs equal, 1 different
+   static const char* phases[3] = { "strash", "optimize", "fraig" };
+   vector<const char*> decidedBy(_poList.size(), (const char*)0);
+   unsigned aigs[4], decided[3];
+   double times[4];
+
+   aigs[0] = _andGateCount;
+   times[0] = cpuTime();
+   for (size_t p = 0; p < 3; p++) {
+      if (p == 0) strash();
+      else if (p == 1) optimize();
+      else {
+         // the simulation is only there for fraig
+         randomSim();
+         // the two halves meet from the PIs up, each proof helping the next
+         fraig(false, FRAIG_ORDER_TOPO, CUT_MAX_SIZE);
+      }
+      aigs[p + 1] = _andGateCount;
+      times[p + 1] = cpuTime();
+      decided[p] = markDecided(_poList, _gates[0], decidedBy, phases[p]);
+   }
+   cout << "Miter: " << aigs[0] << " AIGs -> " << aigs[3]
+        << " by strash, optimize and fraig in " << fixed << setprecision(4)
+        << times[3] - times[0] << " s" << endl;
+   for (size_t p = 0; p < 3; p++)
+      cout << "  " << setw(8) << left << phases[p] << right << ": "
+           << aigs[p] << " -> " << aigs[p + 1]
+           << " AIGs, " << decided[p] << " outputs decided in "
+           << times[p + 1] - times[p] << " s" << endl;
+
+   SatSolver s;
+   s.initialize();
+   genProofModel(s);
+   // the PIs no PO reaches have any value
+   CirGate::clearMark();
+   GateList& l = getDfsList();
+   for (size_t i = 0, n = l.size(); i < n; i++) l[i]->mark();
+   for (size_t i = 0, n = _piList.size(); i < n; i++)
+      if (!_piList[i]->isMarked()) _piList[i]->_satVar = s.newVar();
+
+   unsigned nDiff = 0, nSat = 0;
+   double satTime = 0;
+   for (size_t i = 0, n = _poList.size(); i < n; i++) {
+      const CirGate* po = _poList[i];
+      CirGate* g = po->getFanin(0);
+      cout << "  Output " << i;
+      if (!po->_name.empty()) cout << " (" << po->_name << ")";
+      cout << ": ";
+
+      bool diff;
+      if (g == _gates[0]) {
+         diff = po->getInv(0);
+         cout << (diff ? "DIFFERENT" : "EQUAL") << " by " << decidedBy[i] << endl;
+         if (!diff) continue;
+         s.assumeRelease();
+         s.assumpSolve();
+      } else {
+         double t = cpuTime();
+         s.assumeRelease();
+         s.assumeProperty(g->_satVar, !po->getInv(0));
+         {
+            CirPhaseScope prof(_profiler, PHASE_SAT);
+            diff = s.assumpSolve();
+         }
+         t = cpuTime() - t;
+         satTime += t;
+         nSat++;
+         cout << (diff ? "DIFFERENT" : "EQUAL") << " by SAT in "
+              << setprecision(4) << t << " s" << endl;
+         if (!diff) continue;
+      }
+      nDiff++;
+      cout << "    Counterexample: ";
+      for (size_t j = 0, m = _piList.size(); j < m; j++)
+         cout << (s.getValue(_piList[j]->_satVar) == 1 ? 1 : 0);
+      cout << endl;
+   }
+   cout << "  " << setw(8) << left << "SAT" << right << ": " << nSat
+        << " outputs decided in " << setprecision(4) << satTime << " s"
+        << endl;
+   cout.unsetf(ios::fixed);
+   cout << setprecision(6);
+
+   cout << "CEC: " << _poList.size() - nDiff << " of " << _poList.size()
+        << " outputs equal, " << nDiff << " different" << endl;
+   return nDiff;
+}
+
+/*******************************************/
+/*   Private member functions about CEC    */
+/*******************************************/
+// the AIGs (and the UNDEF gates) reaching the POs of src, by their
+// literals in this one; the PIs are given
+void
+CirMgr::addMiterCone(const CirMgr& src, IdList& lits)
+{
+   GateList& l = src.getDfsList();
+   for (size_t i = 0, n = l.size(); i < n; i++) {
+      const CirGate* g = l[i];
+      if (g->_type == UNDEF_GATE)
+         lits[g->getID()] = 2 * ++_maxNum;
+      else if (g->isAig()) {
+         lits[g->getID()] = 2 * ++_maxNum;
+         addAIG(0, lits[g->getID()],
+                lits[g->getFanin(0)->getID()] ^ g->getInv(0),
+                lits[g->getFanin(1)->getID()] ^ g->getInv(1));
+         _andGateCount++;
+      }
+   }
+}
@@ -7,11 +7,13 @@
 ****************************************************************************/
 
 #include <cassert>
+#include <climits>
 #include <iostream>
 #include <iomanip>
 #include "cirMgr.h"
 #include "cirGate.h"
 #include "cirCmd.h"
+#include "cirGen.h"
 #include "util.h"
 
 using namespace std;
@@ -23,14 +25,23 @@ bool
 initCirCmd()
 {
    if (!(cmdMgr->regCmd("CIRRead", 4, new CirReadCmd) &&
+         cmdMgr->regCmd("CIRGENerate", 6, new CirGenCmd) &&
          cmdMgr->regCmd("CIRPrint", 4, new CirPrintCmd) &&
          cmdMgr->regCmd("CIRGate", 4, new CirGateCmd) &&
          cmdMgr->regCmd("CIRSWeep", 5, new CirSweepCmd) &&
          cmdMgr->regCmd("CIROPTimize", 6, new CirOptCmd) &&
          cmdMgr->regCmd("CIRSTRash", 6, new CirStrashCmd) &&
+         cmdMgr->regCmd("CIRREWrite", 6, new CirRewriteCmd) &&
+         cmdMgr->regCmd("CIRBalance", 4, new CirBalanceCmd) &&
+         cmdMgr->regCmd("CIRODc", 5, new CirOdcCmd) &&
+         cmdMgr->regCmd("CIRCUt", 5, new CirCutCmd) &&
          cmdMgr->regCmd("CIRSIMulate", 6, new CirSimCmd) &&
+         cmdMgr->regCmd("CIRSIGnature", 6, new CirSigCmd) &&
          cmdMgr->regCmd("CIRFraig", 4, new CirFraigCmd) &&
-         cmdMgr->regCmd("CIRWrite", 4, new CirWriteCmd)
+         cmdMgr->regCmd("CIRWrite", 4, new CirWriteCmd) &&
+         cmdMgr->regCmd("CIRPROfile", 6, new CirProfCmd) &&
+         cmdMgr->regCmd("CIRVerbose", 4, new CirVerboseCmd) &&
+         cmdMgr->regCmd("CIRCEc", 5, new CirCecCmd)
       )) {
       cerr << "Registering \"cir\" commands fails... exiting" << endl;
       return false;
@@ -53,8 +64,11 @@ enum CirCmdState
 
 static CirCmdState curCmd = CIRINIT;
 
+// kept for the circuits read or generated later
+static CirVerbosity curVerbosity = CIR_VERB_ITEM;
+
 //----------------------------------------------------------------------
-//    CIRRead <(string fileName)> [-Replace]
+//    CIRRead <(string fileName)> [-Replace] [-Strash]
 //----------------------------------------------------------------------
 CmdExecStatus
 CirReadCmd::exec(const string& option)
@@ -66,13 +80,17 @@ CirReadCmd::exec(const string& option)
    if (options.empty())
       return CmdExec::errorOption(CMD_OPT_MISSING, "");
 
-   bool doReplace = false;
+   bool doReplace = false, doStrash = false;
    string fileName;
    for (size_t i = 0, n = options.size(); i < n; ++i) {
       if (myStrNCmp("-Replace", options[i], 2) == 0) {
          if (doReplace) return CmdExec::errorOption(CMD_OPT_EXTRA,options[i]);
          doReplace = true;
       }
+      else if (myStrNCmp("-Strash", options[i], 2) == 0) {
+         if (doStrash) return CmdExec::errorOption(CMD_OPT_EXTRA,options[i]);
+         doStrash = true;
+      }
       else {
          if (fileName.size())
             return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
@@ -92,8 +110,9 @@ CirReadCmd::exec(const string& option)
       }
    }
    cirMgr = new CirMgr;
+   cirMgr->setVerbosity(curVerbosity);
 
-   if (!cirMgr->readCircuit(fileName)) {
+   if (!cirMgr->readCircuit(fileName, doStrash)) {
       curCmd = CIRINIT;
       delete cirMgr; cirMgr = 0;
       return CMD_EXEC_ERROR;
@@ -107,7 +126,7 @@ CirReadCmd::exec(const string& option)
 void
 CirReadCmd::usage(ostream& os) const
 {
-   os << "Usage: CIRRead <(string fileName)> [-Replace]" << endl;
+   os << "Usage: CIRRead <(string fileName)> [-Replace] [-Strash]" << endl;
 }
 
 void
@@ -117,6 +136,133 @@ CirReadCmd::help() const
         << "read in a circuit and construct the netlist" << endl;
 }
 
+//----------------------------------------------------------------------
+//    CIRGENerate <-Multiplier (int width) | -Adder (int width) |
+//                 -RAndom (int ands) [-Inputs (int n)] [-Depth (int d)]
+//                 [-Fanout <Uniform | Power>]>
+//                [-REDundancy (int percent)] [-Seed (int s)] [-REPlace]
+//----------------------------------------------------------------------
+CmdExecStatus
+CirGenCmd::exec(const string& option)
+{
+   // check option
+   vector<string> options;
+   CmdExec::lexOptions(option, options);
+   if (options.empty())
+      return CmdExec::errorOption(CMD_OPT_MISSING, "");
+
+   CirGenSpec spec;
+   bool hasKind = false, hasInputs = false, hasDepth = false, hasFanout = false;
+   bool hasRedundancy = false, hasSeed = false, doReplace = false;
+   for (size_t i = 0, n = options.size(); i < n; ++i) {
+      bool* has = 0;
+      unsigned* value = 0;
+      int lower = 1, upper = INT_MAX;
+      if (myStrNCmp("-Multiplier", options[i], 2) == 0) {
+         has = &hasKind; value = &spec._width; upper = 65535;
+         spec._kind = GEN_MULTIPLIER;
+      }
+      else if (myStrNCmp("-Adder", options[i], 2) == 0) {
+         has = &hasKind; value = &spec._width;
+         spec._kind = GEN_ADDER;
+      }
+      else if (myStrNCmp("-RAndom", options[i], 3) == 0) {
+         has = &hasKind; value = &spec._ands;
+         spec._kind = GEN_RANDOM;
+      }
+      else if (myStrNCmp("-Inputs", options[i], 2) == 0) {
+         has = &hasInputs; value = &spec._inputs; lower = 2;
+      }
+      else if (myStrNCmp("-Depth", options[i], 2) == 0) {
+         has = &hasDepth; value = &spec._depth;
+      }
+      else if (myStrNCmp("-REDundancy", options[i], 4) == 0) {
+         has = &hasRedundancy; value = &spec._redundancy; lower = 0; upper = 100;
+      }
+      else if (myStrNCmp("-Seed", options[i], 2) == 0) {
+         has = &hasSeed; value = &spec._seed; lower = 0;
+      }
+      else if (myStrNCmp("-Fanout", options[i], 2) == 0) {
+         if (hasFanout)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         if (myStrNCmp("Uniform", options[i], 1) == 0)
+            spec._fanout = GEN_FANOUT_UNIFORM;
+         else if (myStrNCmp("Power", options[i], 1) == 0)
+            spec._fanout = GEN_FANOUT_POWER;
+         else return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+         hasFanout = true;
+         continue;
+      }
+      else if (myStrNCmp("-REPlace", options[i], 4) == 0) {
+         if (doReplace)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         doReplace = true;
+         continue;
+      }
+      else return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+
+      // an option with a number
+      if (*has)
+         return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+      if (++i == n)
+         return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+      int num;
+      if (!myStr2Int(options[i], num) || num < lower || num > upper)
+         return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+      *value = num;
+      *has = true;
+   }
+   if (!hasKind)
+      return CmdExec::errorOption(CMD_OPT_MISSING, "");
+   // the shape of a random DAG only
+   if (spec._kind != GEN_RANDOM && (hasInputs || hasDepth || hasFanout))
+      return CmdExec::errorOption(CMD_OPT_ILLEGAL,
+         hasInputs ? "-Inputs" : hasDepth ? "-Depth" : "-Fanout");
+
+   if (cirMgr != 0) {
+      if (doReplace) {
+         cerr << "Note: original circuit is replaced..." << endl;
+         curCmd = CIRINIT;
+         delete cirMgr; cirMgr = 0;
+      }
+      else {
+         cerr << "Error: circuit already exists!!" << endl;
+         return CMD_EXEC_ERROR;
+      }
+   }
+   cirMgr = new CirMgr;
+   cirMgr->setVerbosity(curVerbosity);
+
+   if (!cirMgr->generate(spec)) {
+      curCmd = CIRINIT;
+      delete cirMgr; cirMgr = 0;
+      return CMD_EXEC_ERROR;
+   }
+
+   curCmd = CIRREAD;
+
+   return CMD_EXEC_DONE;
+}
+
+void
+CirGenCmd::usage(ostream& os) const
+{
+   os << "Usage: CIRGENerate <-Multiplier (int width) | -Adder (int width) |" << endl
+      << "                    -RAndom (int ands) [-Inputs (int n)] [-Depth (int d)]" << endl
+      << "                    [-Fanout <Uniform | Power>]>" << endl
+      << "                   [-REDundancy (int percent)] [-Seed (int s)] [-REPlace]"
+      << endl;
+}
+
+void
+CirGenCmd::help() const
+{
+   cout << setw(15) << left << "CIRGENerate: "
+        << "generate a synthetic circuit as the netlist" << endl;
+}
+
 //----------------------------------------------------------------------
 //    CIRPrint [-Summary | -Netlist | -PI | -PO | -FLoating | -FECpairs]
 //----------------------------------------------------------------------
@@ -144,6 +290,8 @@ CirPrintCmd::exec(const string& option)
       cirMgr->printFloatGates();
    else if (myStrNCmp("-FECpairs", token, 4) == 0)
       cirMgr->printFECPairs();
+   else if (myStrNCmp("-MEMory", token, 4) == 0)
+      cirMgr->printMemory();
    else
       return CmdExec::errorOption(CMD_OPT_ILLEGAL, token);
 
@@ -154,7 +302,7 @@ void
 CirPrintCmd::usage(ostream& os) const
 {  
    os << "Usage: CIRPrint [-Summary | -Netlist | -PI | -PO | -FLoating "
-      << "| -FECpairs]" << endl;
+      << "| -FECpairs | -MEMory]" << endl;
 }
 
 void
@@ -250,7 +398,7 @@ CirGateCmd::help() const
 }
 
 //----------------------------------------------------------------------
-//    CIRSWeep
+//    CIRSWeep [-Quiet]
 //----------------------------------------------------------------------
 CmdExecStatus
 CirSweepCmd::exec(const string& option)
@@ -260,14 +408,18 @@ CirSweepCmd::exec(const string& option)
       return CMD_EXEC_ERROR;
    }
    // check option
-   vector<string> options;
-   CmdExec::lexOptions(option, options);
+   string token;
+   if (!CmdExec::lexSingleOption(option, token))
+      return CMD_EXEC_ERROR;
 
-   if (!options.empty())
-      return CmdExec::errorOption(CMD_OPT_EXTRA, options[0]);
+   bool quiet = false;
+   if (!token.empty()) {
+      if (myStrNCmp("-Quiet", token, 2) == 0) quiet = true;
+      else return CmdExec::errorOption(CMD_OPT_ILLEGAL, token);
+   }
 
    assert(curCmd != CIRINIT);
-   cirMgr->sweep();
+   cirMgr->sweep(quiet);
 
    return CMD_EXEC_DONE;
 }
@@ -275,7 +427,7 @@ CirSweepCmd::exec(const string& option)
 void
 CirSweepCmd::usage(ostream& os) const
 {
-   os << "Usage: CIRSWeep" << endl;
+   os << "Usage: CIRSWeep [-Quiet]" << endl;
 }
 
 void
@@ -373,9 +525,213 @@ CirStrashCmd::help() const
         << "perform structural hash on the circuit netlist\n";
 }
 
+//----------------------------------------------------------------------
+//    CIRREWrite
+//----------------------------------------------------------------------
+CmdExecStatus
+CirRewriteCmd::exec(const string& option)
+{
+   if (!cirMgr) {
+      cerr << "Error: circuit is not yet constructed!!" << endl;
+      return CMD_EXEC_ERROR;
+   }
+   // check option
+   vector<string> options;
+   CmdExec::lexOptions(option, options);
+
+   if (!options.empty())
+      return CmdExec::errorOption(CMD_OPT_EXTRA, options[0]);
+
+   assert(curCmd != CIRINIT);
+   if (curCmd == CIRSIMULATE) {
+      cerr << "Error: circuit has been simulated!! Do \"CIRFraig\" first!!"
+           << endl;
+      return CMD_EXEC_ERROR;
+   }
+   cirMgr->rewrite();
+   curCmd = CIROPT;
+
+   return CMD_EXEC_DONE;
+}
+
+void
+CirRewriteCmd::usage(ostream& os) const
+{
+   os << "Usage: CIRREWrite" << endl;
+}
+
+void
+CirRewriteCmd::help() const
+{
+   cout << setw(15) << left << "CIRREWrite: "
+        << "rewrite 4-input cones with smaller AIG structures\n";
+}
+
+//----------------------------------------------------------------------
+//    CIRBalance
+//----------------------------------------------------------------------
+CmdExecStatus
+CirBalanceCmd::exec(const string& option)
+{
+   if (!cirMgr) {
+      cerr << "Error: circuit is not yet constructed!!" << endl;
+      return CMD_EXEC_ERROR;
+   }
+   // check option
+   vector<string> options;
+   CmdExec::lexOptions(option, options);
+
+   if (!options.empty())
+      return CmdExec::errorOption(CMD_OPT_EXTRA, options[0]);
+
+   assert(curCmd != CIRINIT);
+   if (curCmd == CIRSIMULATE) {
+      cerr << "Error: circuit has been simulated!! Do \"CIRFraig\" first!!"
+           << endl;
+      return CMD_EXEC_ERROR;
+   }
+   cirMgr->balance();
+   curCmd = CIROPT;
+
+   return CMD_EXEC_DONE;
+}
+
+void
+CirBalanceCmd::usage(ostream& os) const
+{
+   os << "Usage: CIRBalance" << endl;
+}
+
+void
+CirBalanceCmd::help() const
+{
+   cout << setw(15) << left << "CIRBalance: "
+        << "balance AND trees to reduce the logic depth\n";
+}
+
+//----------------------------------------------------------------------
+//    CIRODc [-Window <(int levels)>]
+//----------------------------------------------------------------------
+CmdExecStatus
+CirOdcCmd::exec(const string& option)
+{
+   if (!cirMgr) {
+      cerr << "Error: circuit is not yet constructed!!" << endl;
+      return CMD_EXEC_ERROR;
+   }
+   // check option
+   vector<string> options;
+   CmdExec::lexOptions(option, options);
+
+   bool doWindow = false;
+   int levels = ODC_WINDOW;
+   for (size_t i = 0, n = options.size(); i < n; ++i) {
+      if (myStrNCmp("-Window", options[i], 2) == 0) {
+         if (doWindow)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         if (!myStr2Int(options[i], levels) || levels < 1)
+            return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+         doWindow = true;
+      }
+      else
+         return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+   }
+
+   assert(curCmd != CIRINIT);
+   if (curCmd == CIRSIMULATE) {
+      cerr << "Error: circuit has been simulated!! Do \"CIRFraig\" first!!"
+           << endl;
+      return CMD_EXEC_ERROR;
+   }
+   cirMgr->odcSweep(levels);
+   curCmd = CIROPT;
+
+   return CMD_EXEC_DONE;
+}
+
+void
+CirOdcCmd::usage(ostream& os) const
+{
+   os << "Usage: CIRODc [-Window <(int levels)>]" << endl;
+}
+
+void
+CirOdcCmd::help() const
+{
+   cout << setw(15) << left << "CIRODc: "
+        << "remove the AIGs no PO can observe, by don't cares\n";
+}
+
+//----------------------------------------------------------------------
+//    CIRCUt [-K <(int k)>] [-Priority <(int limit)>] [-Stats]
+//----------------------------------------------------------------------
+CmdExecStatus
+CirCutCmd::exec(const string& option)
+{
+   if (!cirMgr) {
+      cerr << "Error: circuit is not yet constructed!!" << endl;
+      return CMD_EXEC_ERROR;
+   }
+   // check option
+   vector<string> options;
+   CmdExec::lexOptions(option, options);
+
+   bool doK = false, doPriority = false, doStats = false;
+   int k = CUT_SIZE, limit = CUT_PRIORITY;
+   for (size_t i = 0, n = options.size(); i < n; ++i) {
+      if (myStrNCmp("-K", options[i], 2) == 0) {
+         if (doK)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         if (!myStr2Int(options[i], k) || k < 2 || k > (int)CUT_MAX_SIZE)
+            return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+         doK = true;
+      }
+      else if (myStrNCmp("-Priority", options[i], 2) == 0) {
+         if (doPriority)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         if (!myStr2Int(options[i], limit) || limit < 1)
+            return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+         doPriority = true;
+      }
+      else if (myStrNCmp("-Stats", options[i], 2) == 0) {
+         if (doStats)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         doStats = true;
+      }
+      else
+         return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+   }
+
+   cirMgr->enumerateCuts(k, limit, doStats);
+
+   return CMD_EXEC_DONE;
+}
+
+void
+CirCutCmd::usage(ostream& os) const
+{
+   os << "Usage: CIRCUt [-K <(int k)>] [-Priority <(int limit)>] [-Stats]"
+      << endl;
+}
+
+void
+CirCutCmd::help() const
+{
+   cout << setw(15) << left << "CIRCUt: "
+        << "enumerate k-feasible cuts of the AIGs\n";
+}
+
 //----------------------------------------------------------------------
 //    CIRSIMulate <-Random | -File <string patternFile>>
-//                [-Output (string logFile)]
+//                [-Output (string logFile) [-BInary]] [-Stats]
+//                [-Idle <(int rounds)>] [-BUdget <(int patterns)>]
+//                [-Time <(int seconds)>] [-Guided]
 //----------------------------------------------------------------------
 CmdExecStatus
 CirSimCmd::exec(const string& option)
@@ -388,9 +744,11 @@ CirSimCmd::exec(const string& option)
    vector<string> options;
    CmdExec::lexOptions(option, options);
 
-   ifstream patternFile;
+   CirPatternReader patternFile;
    ofstream logFile;
-   bool doRandom = false, doFile = false, doLog = false;
+   bool doRandom = false, doFile = false, doLog = false, doBinary = false;
+   bool doIdle = false, doBudget = false, doTime = false, doGuided = false;
+   CirSimEffort effort;
    for (size_t i = 0, n = options.size(); i < n; ++i) {
       if (myStrNCmp("-Random", options[i], 2) == 0) {
          if (doRandom || doFile)
@@ -402,8 +760,7 @@ CirSimCmd::exec(const string& option)
             return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
          if (++i == n)
             return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
-         patternFile.open(options[i].c_str(), ios::in);
-         if (!patternFile)
+         if (!patternFile.open(options[i]))
             return CmdExec::errorOption(CMD_OPT_FOPEN_FAIL, options[i]);
          doFile = true;
       }
@@ -417,22 +774,79 @@ CirSimCmd::exec(const string& option)
             return CmdExec::errorOption(CMD_OPT_FOPEN_FAIL, options[i]);
          doLog = true;
       }
+      else if (myStrNCmp("-Idle", options[i], 2) == 0) {
+         if (doIdle)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         int num;
+         if (!myStr2Int(options[i], num) || num <= 0)
+            return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+         effort._idle = num;
+         doIdle = true;
+      }
+      else if (myStrNCmp("-BInary", options[i], 3) == 0) {
+         if (doBinary)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         doBinary = true;
+      }
+      else if (myStrNCmp("-BUdget", options[i], 3) == 0) {
+         if (doBudget)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         int num;
+         if (!myStr2Int(options[i], num) || num <= 0)
+            return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+         effort._patterns = num;
+         doBudget = true;
+      }
+      else if (myStrNCmp("-Time", options[i], 2) == 0) {
+         if (doTime)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         int num;
+         if (!myStr2Int(options[i], num) || num <= 0)
+            return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+         effort._seconds = num;
+         doTime = true;
+      }
+      else if (myStrNCmp("-Guided", options[i], 2) == 0) {
+         if (doGuided)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         doGuided = true;
+      }
+      else if (myStrNCmp("-Stats", options[i], 2) == 0) {
+         if (effort._stats)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         effort._stats = true;
+      }
       else
          return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
    }
 
    if (!doRandom && !doFile)
       return CmdExec::errorOption(CMD_OPT_MISSING, "");
+   // the effort only applies to random simulation
+   if (doFile && (doIdle || doBudget || doTime || doGuided))
+      return CmdExec::errorOption(CMD_OPT_ILLEGAL, doIdle ? "-Idle" :
+                                  doBudget ? "-BUdget" : doTime ? "-Time" : "-Guided");
 
    assert (curCmd != CIRINIT);
+   // a binary log needs a file
+   if (doBinary && !doLog)
+      return CmdExec::errorOption(CMD_OPT_ILLEGAL, "-BInary");
    if (doLog)
-      cirMgr->setSimLog(&logFile);
+      cirMgr->setSimLog(&logFile, doBinary);
    else cirMgr->setSimLog(0);
 
-   if (doRandom)
-      cirMgr->randomSim();
+   if (doRandom) {
+      cirMgr->randomSim(effort);
+      if (doGuided) cirMgr->guidedSim(effort);
+   }
    else
-      cirMgr->fileSim(patternFile);
+      cirMgr->fileSim(patternFile, effort._stats);
    cirMgr->setSimLog(0);
    curCmd = CIRSIMULATE;
    
@@ -443,7 +857,9 @@ void
 CirSimCmd::usage(ostream& os) const
 {
    os << "Usage: CIRSIMulate <-Random | -File <string patternFile>>\n"
-      << "                   [-Output (string logFile)]" << endl;
+      << "                   [-Output (string logFile) [-BInary]] [-Stats]\n"
+      << "                   [-Idle <(int rounds)>] [-BUdget <(int patterns)>]\n"
+      << "                   [-Time <(int seconds)>] [-Guided]" << endl;
 }
 
 void
@@ -454,7 +870,72 @@ CirSimCmd::help() const
 }
 
 //----------------------------------------------------------------------
-//    CIRFraig
+//    CIRSIGnature <-Save | -Load> <(string sigFile)>
+//----------------------------------------------------------------------
+CmdExecStatus
+CirSigCmd::exec(const string& option)
+{
+   if (!cirMgr) {
+      cerr << "Error: circuit is not yet constructed!!" << endl;
+      return CMD_EXEC_ERROR;
+   }
+   // check option
+   vector<string> options;
+   CmdExec::lexOptions(option, options);
+
+   bool doSave = false, doLoad = false;
+   string fileName;
+   for (size_t i = 0, n = options.size(); i < n; ++i) {
+      if (myStrNCmp("-Save", options[i], 2) == 0 ||
+          myStrNCmp("-Load", options[i], 2) == 0) {
+         if (doSave || doLoad)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         if (myStrNCmp("-Save", options[i-1], 2) == 0) doSave = true;
+         else doLoad = true;
+         fileName = options[i];
+      }
+      else
+         return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+   }
+   if (!doSave && !doLoad)
+      return CmdExec::errorOption(CMD_OPT_MISSING, "");
+
+   assert(curCmd != CIRINIT);
+   if (doSave) {
+      if (curCmd != CIRSIMULATE) {
+         cerr << "Error: circuit is not yet simulated!!" << endl;
+         return CMD_EXEC_ERROR;
+      }
+      if (!cirMgr->saveSignatures(fileName))
+         return CMD_EXEC_ERROR;
+   }
+   else {
+      if (!cirMgr->loadSignatures(fileName))
+         return CMD_EXEC_ERROR;
+      curCmd = CIRSIMULATE;
+   }
+
+   return CMD_EXEC_DONE;
+}
+
+void
+CirSigCmd::usage(ostream& os) const
+{
+   os << "Usage: CIRSIGnature <-Save | -Load> <(string sigFile)>" << endl;
+}
+
+void
+CirSigCmd::help() const
+{
+   cout << setw(15) << left << "CIRSIGnature: "
+        << "save or load simulation signatures and FEC groups\n";
+}
+
+//----------------------------------------------------------------------
+//    CIRFraig [-Preprocess] [-Order <topo | group>] [-Cut <(int k)>]
+//             [-PArallel <(int threads)> | -Drat <(string name)>]
 //----------------------------------------------------------------------
 CmdExecStatus
 CirFraigCmd::exec(const string& option)
@@ -467,14 +948,76 @@ CirFraigCmd::exec(const string& option)
    vector<string> options;
    CmdExec::lexOptions(option, options);
 
-   if (!options.empty())
-      return CmdExec::errorOption(CMD_OPT_EXTRA, options[0]);
+   bool doPreprocess = false, doOrder = false, doCut = false;
+   string dratName;
+   FraigOrder order = FRAIG_ORDER_GROUP;
+   int cutSize = FRAIG_CUT_SIZE, threads = 0;
+   for (size_t i = 0, n = options.size(); i < n; ++i) {
+      if (myStrNCmp("-Preprocess", options[i], 2) == 0) {
+         if (doPreprocess)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         doPreprocess = true;
+      }
+      else if (myStrNCmp("-Order", options[i], 2) == 0) {
+         if (doOrder)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         if (myStrNCmp("topo", options[i], 1) == 0)
+            order = FRAIG_ORDER_TOPO;
+         else if (myStrNCmp("group", options[i], 1) == 0)
+            order = FRAIG_ORDER_GROUP;
+         else
+            return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+         doOrder = true;
+      }
+      else if (myStrNCmp("-Cut", options[i], 2) == 0) {
+         if (doCut)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         if (!myStr2Int(options[i], cutSize) || cutSize < 0 || cutSize == 1 ||
+             cutSize > (int)CUT_MAX_SIZE)
+            return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+         doCut = true;
+      }
+      else if (myStrNCmp("-PArallel", options[i], 3) == 0) {
+         if (threads)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         if (!myStr2Int(options[i], threads) || threads <= 0)
+            return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+      }
+      else if (myStrNCmp("-Drat", options[i], 2) == 0) {
+         if (!dratName.empty())
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         dratName = options[i];
+      }
+      else
+         return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+   }
+   // the jobs prove on solvers of their own
+   if (threads && !dratName.empty()) {
+      cerr << "Error: -Drat cannot be used with -PArallel!!" << endl;
+      return CMD_EXEC_ERROR;
+   }
+   if (!dratName.empty()) {
+      ofstream proof((dratName + ".drat").c_str());
+      if (!proof)
+         return CmdExec::errorOption(CMD_OPT_FOPEN_FAIL, dratName + ".drat");
+   }
 
-   if (curCmd != CIRSIMULATE) {
+   // the cones are simulated on their own
+   if (threads)
+      cirMgr->fraigParallel(threads, doPreprocess, order, cutSize);
+   else if (curCmd != CIRSIMULATE) {
       cerr << "Error: circuit is not yet simulated!!" << endl;
       return CMD_EXEC_ERROR;
    }
-   cirMgr->fraig();
+   else cirMgr->fraig(doPreprocess, order, cutSize, dratName);
    curCmd = CIRFRAIG;
 
    return CMD_EXEC_DONE;
@@ -483,7 +1026,15 @@ CirFraigCmd::exec(const string& option)
 void
 CirFraigCmd::usage(ostream& os) const
 {
-   os << "Usage: CIRFraig" << endl;
+   os << "Usage: CIRFraig [-Preprocess] [-Order <topo | group>] [-Cut <(int k)>]" << endl
+      << "                [-PArallel <(int threads)> | -Drat <(string name)>]" << endl
+      << "  -Cut k: decide pairs by truth tables over k-input cuts before SAT" << endl
+      << "          (k = 2..6, or 0 for SAT only; 4 by default)" << endl
+      << "  -PArallel n: fraig the independent PO cones in n threads, then" << endl
+      << "               fraig the circuit left to merge across them" << endl
+      << "  -Drat name: write the proof model to name.cnf and a binary DRAT" << endl
+      << "              proof of every merge to name.drat (the cuts then" << endl
+      << "              only refute pairs)" << endl;
 }
 
 void
@@ -494,7 +1045,7 @@ CirFraigCmd::help() const
 }
 
 //----------------------------------------------------------------------
-//    CIRWrite [(int gateId)][-Output (string aagFile)]
+//    CIRWrite [(int gateId)][-Output (string aagFile) [-Binary]]
 //----------------------------------------------------------------------
 CmdExecStatus
 CirWriteCmd::exec(const string& option)
@@ -511,9 +1062,10 @@ CirWriteCmd::exec(const string& option)
       cirMgr->writeAag(cout);
       return CMD_EXEC_DONE;
    }
-   bool hasFile = false;
+   bool hasFile = false, doBinary = false;
    int gateId;
    CirGate *thisGate = NULL;
+   string fileName;
    ofstream outfile;
    for (size_t i = 0, n = options.size(); i < n; ++i) {
       if (myStrNCmp("-Output", options[i], 2) == 0) {
@@ -521,11 +1073,14 @@ CirWriteCmd::exec(const string& option)
             return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
          if (++i == n)
             return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
-         outfile.open(options[i].c_str(), ios::out);
-         if (!outfile)
-            return CmdExec::errorOption(CMD_OPT_FOPEN_FAIL, options[1]);
+         fileName = options[i];
          hasFile = true;
       }
+      else if (myStrNCmp("-Binary", options[i], 2) == 0) {
+         if (doBinary)
+            return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         doBinary = true;
+      }
       else if (myStr2Int(options[i], gateId) && gateId >= 0) {
          if (thisGate != NULL)
             return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
@@ -541,8 +1096,17 @@ CirWriteCmd::exec(const string& option)
       }
       else return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
    }
+   // the whole netlist only, to a file
+   if (doBinary && (!hasFile || thisGate))
+      return CmdExec::errorOption(CMD_OPT_ILLEGAL, "-Binary");
+   if (hasFile) {
+      outfile.open(fileName.c_str(), doBinary ? ios::out | ios::binary : ios::out);
+      if (!outfile)
+         return CmdExec::errorOption(CMD_OPT_FOPEN_FAIL, fileName);
+   }
 
-   if (!thisGate) {
+   if (doBinary) cirMgr->writeAig(outfile);
+   else if (!thisGate) {
       assert (hasFile);
       cirMgr->writeAag(outfile);
    }
@@ -555,7 +1119,7 @@ CirWriteCmd::exec(const string& option)
 void
 CirWriteCmd::usage(ostream& os) const
 {
-   os << "Usage: CIRWrite [(int gateId)][-Output (string aagFile)]" << endl;
+   os << "Usage: CIRWrite [(int gateId)][-Output (string aagFile) [-Binary]]" << endl;
 }
 
 void
@@ -565,3 +1129,154 @@ CirWriteCmd::help() const
         << "write the netlist to an ASCII AIG file (.aag)\n";
 }
 
+
+//----------------------------------------------------------------------
+//    CIRPROfile [-Json] [-Output (string file)] [-Reset]
+//----------------------------------------------------------------------
+CmdExecStatus
+CirProfCmd::exec(const string& option)
+{
+   if (!cirMgr) {
+      cerr << "Error: circuit is not yet constructed!!" << endl;
+      return CMD_EXEC_ERROR;
+   }
+   // check option
+   vector<string> options;
+   CmdExec::lexOptions(option, options);
+
+   bool doJson = false, doReset = false, hasFile = false;
+   ofstream outfile;
+   for (size_t i = 0, n = options.size(); i < n; ++i) {
+      if (myStrNCmp("-Json", options[i], 2) == 0) {
+         if (doJson) return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         doJson = true;
+      }
+      else if (myStrNCmp("-Reset", options[i], 2) == 0) {
+         if (doReset) return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         doReset = true;
+      }
+      else if (myStrNCmp("-Output", options[i], 2) == 0) {
+         if (hasFile) return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         if (++i == n)
+            return CmdExec::errorOption(CMD_OPT_MISSING, options[i-1]);
+         outfile.open(options[i].c_str(), ios::out);
+         if (!outfile)
+            return CmdExec::errorOption(CMD_OPT_FOPEN_FAIL, options[i]);
+         hasFile = true;
+      }
+      else return CmdExec::errorOption(CMD_OPT_ILLEGAL, options[i]);
+   }
+
+   // "-Reset" alone only clears the records
+   if (doJson || hasFile || !doReset) {
+      ostream& os = (hasFile ? (ostream&)outfile : cout);
+      if (doJson) cirMgr->getProfiler().reportJson(os);
+      else cirMgr->getProfiler().report(os);
+   }
+   if (doReset) cirMgr->getProfiler().reset();
+
+   return CMD_EXEC_DONE;
+}
+
+void
+CirProfCmd::usage(ostream& os) const
+{
+   os << "Usage: CIRPROfile [-Json] [-Output (string file)] [-Reset]" << endl;
+}
+
+void
+CirProfCmd::help() const
+{
+   cout << setw(15) << left << "CIRPROfile: "
+        << "report time and memory by phase\n";
+}
+
+//----------------------------------------------------------------------
+//    CIRVerbose [(int level)]
+//----------------------------------------------------------------------
+CmdExecStatus
+CirVerboseCmd::exec(const string& option)
+{
+   // check option
+   string token;
+   if (!CmdExec::lexSingleOption(option, token))
+      return CMD_EXEC_ERROR;
+
+   if (token.empty()) {
+      cout << "Verbosity: " << curVerbosity << endl;
+      return CMD_EXEC_DONE;
+   }
+   int level;
+   if (!myStr2Int(token, level) || level < CIR_VERB_SUMMARY || level > CIR_VERB_ITEM)
+      return CmdExec::errorOption(CMD_OPT_ILLEGAL, token);
+
+   curVerbosity = (CirVerbosity)level;
+   if (cirMgr) cirMgr->setVerbosity(curVerbosity);
+
+   return CMD_EXEC_DONE;
+}
+
+void
+CirVerboseCmd::usage(ostream& os) const
+{
+   os << "Usage: CIRVerbose [(int level)]" << endl
+      << "  0: summaries only; 1: and the simulation progress, once a second;" << endl
+      << "  2: and every merge, removal and proof (default)" << endl;
+}
+
+void
+CirVerboseCmd::help() const
+{
+   cout << setw(15) << left << "CIRVerbose: "
+        << "set the verbosity of the circuit commands" << endl;
+}
+
+//----------------------------------------------------------------------
+//    CIRCEc <(string file1)> <(string file2)> [-Name]
+//----------------------------------------------------------------------
+CmdExecStatus
+CirCecCmd::exec(const string& option)
+{
+   // check option
+   vector<string> options;
+   if (!CmdExec::lexOptions(option, options))
+      return CMD_EXEC_ERROR;
+
+   bool byName = false;
+   vector<string> files;
+   for (size_t i = 0, n = options.size(); i < n; ++i) {
+      if (myStrNCmp("-Name", options[i], 2) == 0) {
+         if (byName) return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+         byName = true;
+      }
+      else if (files.size() == 2)
+         return CmdExec::errorOption(CMD_OPT_EXTRA, options[i]);
+      else files.push_back(options[i]);
+   }
+   if (files.size() < 2)
+      return CmdExec::errorOption(CMD_OPT_MISSING, (files.empty() ? "" : files[0]));
+
+   // the current circuit is left alone
+   CirMgr first, second, miter;
+   if (!first.readCircuit(files[0]) || !second.readCircuit(files[1]))
+      return CMD_EXEC_ERROR;
+   miter.setVerbosity(CIR_VERB_NONE);
+   if (!miter.buildMiter(first, second, byName))
+      return CMD_EXEC_ERROR;
+   miter.checkMiter();
+
+   return CMD_EXEC_DONE;
+}
+
+void
+CirCecCmd::usage(ostream& os) const
+{
+   os << "Usage: CIRCEc <(string file1)> <(string file2)> [-Name]" << endl;
+}
+
+void
+CirCecCmd::help() const
+{
+   cout << setw(15) << left << "CIRCEc: "
+        << "check two circuits for equivalence by a miter" << endl;
+}
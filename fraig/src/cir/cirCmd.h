@@ -12,13 +12,22 @@
 #include "cmdParser.h"
 
 CmdClass(CirReadCmd);
+CmdClass(CirGenCmd);
 CmdClass(CirPrintCmd);
 CmdClass(CirGateCmd);
 CmdClass(CirSweepCmd);
 CmdClass(CirOptCmd);
 CmdClass(CirStrashCmd);
+CmdClass(CirRewriteCmd);
+CmdClass(CirBalanceCmd);
+CmdClass(CirOdcCmd);
+CmdClass(CirCutCmd);
 CmdClass(CirSimCmd);
+CmdClass(CirSigCmd);
 CmdClass(CirFraigCmd);
 CmdClass(CirWriteCmd);
+CmdClass(CirProfCmd);
+CmdClass(CirVerboseCmd);
+CmdClass(CirCecCmd);
 
 #endif // CIR_CMD_H
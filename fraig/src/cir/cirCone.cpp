@@ -0,0 +1,278 @@
+/****************************************************************************
+  FileName     [ cirCone.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define output cone extraction and the parallel fraig ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <pthread.h>
+#include "cirMgr.h"
+#include "cirGate.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// the POs of some independent cones, and their circuit
+struct CirConeJob
+{
+   CirConeJob(): _mgr(0), _ands(0), _preprocess(false),
+                 _order(FRAIG_ORDER_GROUP), _cutSize(FRAIG_CUT_SIZE) {}
+   CirMgr*      _mgr;
+   IdList       _pos;       // by index, in order
+   unsigned     _ands;
+   bool         _preprocess;
+   FraigOrder   _order;
+   unsigned     _cutSize;
+};
+
+// union-find over the POs
+static unsigned findCone(IdList& parent, unsigned x)
+{
+   while (parent[x] != x) {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+   }
+   return x;
+}
+
+// the largest cones first, each to the job with the fewest AIGs so far
+struct CirConeSizeCompFN
+{
+   CirConeSizeCompFN(const IdList& ands): _ands(ands) {}
+   bool operator() (unsigned a, unsigned b) const {
+      return _ands[a] != _ands[b] ? _ands[a] > _ands[b] : a < b;
+   }
+   const IdList& _ands;
+};
+
+static void* runConeJob(void* arg)
+{
+   CirConeJob* job = (CirConeJob*)arg;
+   if (job->_pos.empty()) return 0;
+   job->_mgr->randomSim();
+   job->_mgr->fraig(job->_preprocess, job->_order, job->_cutSize);
+   return 0;
+}
+
+/*****************************************/
+/*   Public member functions of CirMgr   */
+/*****************************************/
+// The cones of the POs of the given indices, as a circuit of its own;
+// the gates keep their IDs, names and line numbers, but the POs are
+// numbered anew. Nothing is shared with this one.
+CirMgr*
+CirMgr::extractCone(const IdList& pos) const
+{
+   GateList l;
+   CirGate::clearMark();
+   for (size_t i = 0, n = pos.size(); i < n; i++)
+      _poList[pos[i]]->traversal(&l);
+
+   CirMgr* m = new CirMgr;
+   m->_verbosity = _verbosity;
+   m->_maxNum = _maxNum;
+   m->_latchCount = 0;
+   m->_outputCount = pos.size();
+   m->_andGateCount = 0;
+   m->_gates[0] = new ConstGate();
+
+   for (size_t i = 0, n = _piList.size(); i < n; i++)
+      if (_piList[i]->isMarked())
+         m->addPI(_piList[i]->getLineNo(), 2 * _piList[i]->getID())->_name = _piList[i]->_name;
+   m->_inputCount = m->_piList.size();
+   for (size_t i = 0, n = pos.size(); i < n; i++) {
+      const CirGate* po = _poList[pos[i]];
+      m->addPO(po->getLineNo(), 2 * po->getFanin(0)->getID() + po->getInv(0))->_name = po->_name;
+   }
+   for (size_t i = 0, n = l.size(); i < n; i++) {
+      const CirGate* g = l[i];
+      if (!g->isAig()) continue;
+      m->addAIG(g->getLineNo(), 2 * g->getID(),
+                2 * g->getFanin(0)->getID() + g->getInv(0),
+                2 * g->getFanin(1)->getID() + g->getInv(1));
+      m->_andGateCount++;
+   }
+   // the UNDEF gates are made as in reading
+   m->initialize();
+   return m;
+}
+
+// The POs sharing no AIG are split into independent cones, and the cones
+// into `threads` jobs of about the same #AIGs. Each job is simulated and
+// fraiged as a circuit of its own, in a thread of its own; the AIGs left
+// then take the fanins they have there, and the others are removed. The
+// jobs cannot see equivalences between their cones, so the circuit left
+// is simulated and fraiged once more here.
+void
+CirMgr::fraigParallel(unsigned threads, bool preprocess, FraigOrder order,
+                      unsigned cutSize)
+{
+   // Output Example:
+   //   Job #0: 12 POs, 1200 -> 1010 AIGs
+   //   Parallel fraig: 40 POs in 25 independent cones, 4 threads;
+   //      4800 -> 4020 AIGs, 4000 after merging across jobs (one line)
+   assert(threads > 0);
+   size_t nPOs = _poList.size();
+
+   // the cones meet where a PO reaches an AIG of another one
+   IdList parent(nPOs), ands(nPOs, 0);
+   for (unsigned i = 0; i < nPOs; i++) parent[i] = i;
+   vector<int> owner(_gates.rbegin()->first + 1, -1);
+   GateList stack;
+   for (unsigned i = 0; i < nPOs; i++) {
+      stack.push_back(_poList[i]->getFanin(0));
+      while (!stack.empty()) {
+         CirGate* g = stack.back();
+         stack.pop_back();
+         if (!g->isAig()) continue;
+         int o = owner[g->getID()];
+         if (o >= 0) {
+            parent[findCone(parent, o)] = findCone(parent, i);
+            continue;
+         }
+         owner[g->getID()] = i;
+         ands[i]++;
+         stack.push_back(g->getFanin(0));
+         stack.push_back(g->getFanin(1));
+      }
+   }
+
+   // the cones by the root of their POs, in PO order
+   IdList cones, coneOf(nPOs), coneAnds;
+   for (unsigned i = 0; i < nPOs; i++) {
+      unsigned r = findCone(parent, i);
+      if (r == i) {
+         coneOf[i] = cones.size();
+         cones.push_back(i);
+         coneAnds.push_back(0);
+      }
+   }
+   for (unsigned i = 0; i < nPOs; i++)
+      coneAnds[coneOf[findCone(parent, i)]] += ands[i];
+
+   size_t nJobs = std::max(std::min((size_t)threads, cones.size()), (size_t)1);
+   vector<CirConeJob> jobs(nJobs);
+   IdList bySize(cones.size());
+   for (unsigned c = 0; c < bySize.size(); c++) bySize[c] = c;
+   sort(bySize.begin(), bySize.end(), CirConeSizeCompFN(coneAnds));
+   IdList jobOf(cones.size());
+   for (size_t k = 0, n = bySize.size(); k < n; k++) {
+      size_t j = 0;
+      for (size_t t = 1; t < nJobs; t++)
+         if (jobs[t]._ands < jobs[j]._ands) j = t;
+      jobOf[bySize[k]] = j;
+      jobs[j]._ands += coneAnds[bySize[k]];
+   }
+   for (unsigned i = 0; i < nPOs; i++)
+      jobs[jobOf[coneOf[findCone(parent, i)]]]._pos.push_back(i);
+
+   for (size_t j = 0; j < nJobs; j++) {
+      jobs[j]._mgr = extractCone(jobs[j]._pos);
+      jobs[j]._mgr->setVerbosity(CIR_VERB_NONE);
+      // the same patterns on every run, whichever job draws first
+      jobs[j]._mgr->setRandomSeed(j);
+      jobs[j]._preprocess = preprocess;
+      jobs[j]._order = order;
+      jobs[j]._cutSize = cutSize;
+   }
+
+   // the first job is run here; a job without a thread is run here too
+   vector<pthread_t> tids(nJobs);
+   vector<bool> started(nJobs, false);
+   for (size_t j = 1; j < nJobs; j++)
+      started[j] = (pthread_create(&tids[j], 0, runConeJob, &jobs[j]) == 0);
+   for (size_t j = 0; j < nJobs; j++)
+      if (!started[j]) runConeJob(&jobs[j]);
+   for (size_t j = 1; j < nJobs; j++)
+      if (started[j]) pthread_join(tids[j], 0);
+
+   // every fanout is made again from the fanins in the jobs
+   for (GateMap::iterator it = _gates.begin(); it != _gates.end(); ++it) {
+      it->second->_fanoutList.clear();
+      it->second->_fecGroup = 0;
+   }
+   vector<char> live(_gates.rbegin()->first + 1, 0);
+   unsigned before = _andGateCount;
+   for (size_t j = 0; j < nJobs; j++) {
+      CirMgr& sub = *jobs[j]._mgr;
+      GateList& l = sub.getDfsList();
+      for (size_t i = 0, n = l.size(); i < n; i++) {
+         const CirGate* s = l[i];
+         if (s->_type == PO_GATE) continue;
+         live[s->getID()] = 1;
+         if (!s->isAig()) continue;
+         CirGate* g = getGate(s->getID());
+         for (size_t k = 0; k < 2; k++) {
+            CirGate* f = getGate(s->getFanin(k)->getID());
+            g->setFanin(k, (CirGateV)f | s->getInv(k));
+            f->addFanout((CirGateV)g | s->getInv(k));
+         }
+      }
+      for (size_t i = 0, n = jobs[j]._pos.size(); i < n; i++) {
+         const CirGate* s = sub._poList[i];
+         CirGate* po = _poList[jobs[j]._pos[i]];
+         CirGate* f = getGate(s->getFanin(0)->getID());
+         po->setFanin(0, (CirGateV)f | s->getInv(0));
+         f->addFanout((CirGateV)po | s->getInv(0));
+      }
+      if (isVerbose())
+         cout << "  Job #" << j << ": " << jobs[j]._pos.size() << " POs, "
+              << jobs[j]._ands << " -> " << sub._andGateCount << " AIGs" << endl;
+   }
+
+   GateMap::iterator it = _gates.begin();
+   while (it != _gates.end()) {
+      CirGate* g = it->second;
+      if ((g->isAig() || g->_type == UNDEF_GATE) && !live[g->getID()]) {
+         if (g->isAig()) _andGateCount--;
+         delete g;
+         _gates.erase(it++);
+      } else ++it;
+   }
+   _dfsList_clean = false;
+
+   // as after fraig(); the proof model has the old fanins
+   if (_fecGroupList) {
+      for (size_t i = 0, n = _fecGroupList->size(); i < n; i++)
+         delete _fecGroupList->at(i);
+      delete _fecGroupList;
+      _fecGroupList = 0;
+   }
+   delete _satSolver;
+   _satSolver = 0;
+   for (size_t j = 0; j < nJobs; j++) {
+      _profiler.merge(jobs[j]._mgr->_profiler);
+      delete jobs[j]._mgr;
+   }
+
+   // AIGs of cones in different jobs may still be equivalent; fraig the
+   // much smaller circuit once more, quietly, to merge them
+   unsigned stitched = _andGateCount;
+   if (nJobs > 1 && _andGateCount) {
+      CirVerbosity v = _verbosity;
+      _verbosity = CIR_VERB_NONE;
+      randomSim();
+      fraig(preprocess, order, cutSize);
+      _verbosity = v;
+   }
+
+   #ifdef CHECK_INTEGRITY
+   checkIntegrity();
+   #endif  // CHECK_INTEGRITY
+
+   if (!isSilent())
+      cout << "Parallel fraig: " << nPOs << " POs in " << cones.size()
+           << " independent cones, " << nJobs << " threads; " << before
+           << " -> " << stitched << " AIGs, " << _andGateCount
+           << " after merging across jobs" << endl;
+}
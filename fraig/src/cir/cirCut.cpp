@@ -0,0 +1,327 @@
+/****************************************************************************
+  FileName     [ cirCut.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define k-feasible cut enumeration ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <algorithm>
+#include "cirMgr.h"
+#include "cirGate.h"
+#include "cirCut.h"
+#include "util.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// truth tables of the 6 variables
+static const CirTruthWord cutVarTruth[CUT_MAX_SIZE] = {
+   0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+   0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+};
+
+// exchange variables i < j of t
+static inline CirTruthWord
+swapVars(CirTruthWord t, unsigned i, unsigned j)
+{
+   CirTruthWord up = cutVarTruth[i] & ~cutVarTruth[j];   // i = 1, j = 0
+   CirTruthWord dn = cutVarTruth[j] & ~cutVarTruth[i];   // i = 0, j = 1
+   unsigned shift = (1 << j) - (1 << i);
+   return (t & ~(up | dn)) | ((t & up) << shift) | ((t & dn) >> shift);
+}
+
+static inline unsigned
+countSign(unsigned s)
+{
+   unsigned n = 0;
+   for (; s; s &= s - 1) n++;
+   return n;
+}
+
+// smaller cuts first, then the ones over more shared leaves
+struct CirCutCompFN
+{
+   bool operator() (const CirCut* a, const CirCut* b) const {
+      if (a->_size != b->_size) return a->_size < b->_size;
+      size_t fa = 0, fb = 0;
+      for (size_t i = 0; i < a->_size; i++) fa += a->_leaves[i]->_fanoutList.size();
+      for (size_t i = 0; i < b->_size; i++) fb += b->_leaves[i]->_fanoutList.size();
+      return fa > fb;
+   }
+};
+
+/*****************************************/
+/*   Public member functions about cuts  */
+/*****************************************/
+// Enumerate the cuts of every AIG in the DFS list and report them
+void
+CirMgr::enumerateCuts(unsigned k, unsigned limit, bool stats)
+{
+   // Output Example:
+   // Cuts: XX cuts on YY AIGs (k = K, at most C per AIG)
+   GateList& dfsList = getDfsList();
+   CirCutMgr cutMgr(k, limit);
+
+   double start = cpuTime();
+   cutMgr.enumerate(dfsList);
+   double time = cpuTime() - start;
+
+   size_t nAig = 0, nCut = 0;
+   vector<size_t> sizeCount(k + 1, 0);
+   for (size_t i = 0, n = dfsList.size(); i < n; i++) {
+      if (!dfsList[i]->isAig()) continue;
+      nAig++;
+      // the trivial cut is not counted
+      for (const CirCut* c = cutMgr.getCuts(dfsList[i])->getNext(); c; c = c->getNext()) {
+         nCut++;
+         sizeCount[c->getSize()]++;
+      }
+   }
+   cout << "Cuts: " << nCut << " cuts on " << nAig << " AIGs (k = " << k
+        << ", at most " << limit << " per AIG)" << endl;
+   if (!stats) return;
+
+   for (unsigned s = 1; s <= k; s++)
+      cout << "  " << s << "-input  " << setw(10) << right << sizeCount[s] << endl;
+   cout << "  Avg. cuts per AIG : " << fixed << setprecision(2)
+        << (nAig ? double(nCut) / nAig : 0.0) << endl;
+   cout << "  Enumeration time  : " << setprecision(4)
+        << time << " seconds" << endl;
+   cout << "  Memory (pooled)   : " << setprecision(4)
+        << cutMgr.getMemSize() / double(1 << 20) << " M Bytes" << endl;
+   cout.unsetf(ios::fixed);
+}
+
+/****************************************/
+/*   class CirCutPool member functions  */
+/****************************************/
+CirCutPool::CirCutPool(unsigned k, size_t pageSize):
+   _recSize(sizeof(CirCut) + (k - 1) * sizeof(CirGate*)),
+   _pageSize(pageSize), _pageUsed(pageSize), _freeList(0), _used(0)
+{
+   // keep the records aligned for the words in them
+   _recSize = (_recSize + sizeof(CirTruthWord) - 1) / sizeof(CirTruthWord)
+            * sizeof(CirTruthWord);
+}
+
+CirCut*
+CirCutPool::alloc()
+{
+   _used++;
+   if (_freeList) {
+      CirCut* c = _freeList;
+      _freeList = c->_next;
+      return c;
+   }
+   if (_pageUsed == _pageSize) {
+      _pages.push_back(new char[_pageSize * _recSize]);
+      _pageUsed = 0;
+   }
+   return (CirCut*)(_pages.back() + _recSize * _pageUsed++);
+}
+
+void
+CirCutPool::reset()
+{
+   for (size_t i = 0, n = _pages.size(); i < n; i++)
+      delete [] _pages[i];
+   _pages.clear();
+   _pageUsed = _pageSize;
+   _freeList = 0;
+   _used = 0;
+}
+
+/***************************************/
+/*   class CirCutMgr member functions  */
+/***************************************/
+CirCutMgr::CirCutMgr(unsigned k, unsigned limit):
+   _k(k), _limit(limit), _pool(k), _union(0)
+{
+   assert(k >= 2 && k <= CUT_MAX_SIZE);
+}
+
+// the list is to be in topological order
+void
+CirCutMgr::enumerate(const GateList& l)
+{
+   for (size_t i = 0, n = l.size(); i < n; i++)
+      if (!hasCuts(l[i])) computeCuts(l[i]);
+}
+
+// the fanins without cuts are computed first, without recursion
+const CirCut*
+CirCutMgr::getCuts(CirGate* g)
+{
+   if (hasCuts(g)) return _cuts[g->getID()];
+   _stack.assign(1, g);
+   while (!_stack.empty()) {
+      CirGate* h = _stack.back();
+      if (h->isAig() && !hasCuts(h->getFanin(0)))
+         _stack.push_back(h->getFanin(0));
+      else if (h->isAig() && !hasCuts(h->getFanin(1)))
+         _stack.push_back(h->getFanin(1));
+      else {
+         _stack.pop_back();
+         if (!hasCuts(h)) computeCuts(h);
+      }
+   }
+   return _cuts[g->getID()];
+}
+
+// for a gate deleted or changed; its ID may be taken by another one
+void
+CirCutMgr::removeCuts(CirGate* g)
+{
+   if (!hasCuts(g)) return;
+   CirCut* c = _cuts[g->getID()];
+   while (c) {
+      CirCut* next = c->_next;
+      _pool.free(c);
+      c = next;
+   }
+   _cuts[g->getID()] = 0;
+}
+
+void
+CirCutMgr::reset()
+{
+   _pool.reset();
+   _cuts.clear();
+   _union = 0;
+}
+
+bool
+CirCutMgr::mergeTruth(const CirCut* a, const CirCut* b, CirTruthWord& ta,
+                      CirTruthWord& tb)
+{
+   if (countSign(a->_sign | b->_sign) > _k) return false;
+   if (!_union) _union = _pool.alloc();
+   if (!mergeCut(a, b, _union)) return false;
+   ta = stretchTruth(a, _union);
+   tb = stretchTruth(b, _union);
+   return true;
+}
+
+CirCut*
+CirCutMgr::computeCuts(CirGate* g)
+{
+   if (g->getID() >= _cuts.size()) _cuts.resize(g->getID() + 1, 0);
+
+   CirCut* triv = _pool.alloc();
+   triv->_next = 0;
+   if (g->_type == CONST_GATE) {
+      triv->_size = 0;
+      triv->_sign = 0;
+      triv->_truth = 0;
+      return (_cuts[g->getID()] = triv);
+   }
+   triv->_size = 1;
+   triv->_leaves[0] = g;
+   triv->_sign = 1 << (g->getID() % 32);
+   triv->_truth = cutVarTruth[0];
+   _cuts[g->getID()] = triv;
+   if (!g->isAig()) return triv;
+
+   // the fanins first; the lists are not moved by computing them
+   const CirCut* c0 = getCuts(g->getFanin(0));
+   const CirCut* c1 = getCuts(g->getFanin(1));
+   CirTruthWord m0 = g->getInv(0) ? ~(CirTruthWord)0 : 0;
+   CirTruthWord m1 = g->getInv(1) ? ~(CirTruthWord)0 : 0;
+
+   _cands.clear();
+   CirCut* c = 0;
+   for (const CirCut* a = c0; a; a = a->_next) {
+      for (const CirCut* b = c1; b; b = b->_next) {
+         if (countSign(a->_sign | b->_sign) > _k) continue;
+         if (!c) c = _pool.alloc();
+         if (!mergeCut(a, b, c)) continue;
+
+         bool dominated = false;
+         for (size_t i = 0; i < _cands.size() && !dominated; i++)
+            dominated = dominate(_cands[i], c);
+         if (dominated) continue;
+         for (size_t i = 0; i < _cands.size(); )
+            if (dominate(c, _cands[i])) {
+               _pool.free(_cands[i]);
+               _cands[i] = _cands.back();
+               _cands.pop_back();
+            } else i++;
+
+         c->_truth = (stretchTruth(a, c) ^ m0) & (stretchTruth(b, c) ^ m1);
+         _cands.push_back(c);
+         c = 0;
+      }
+   }
+   if (c) _pool.free(c);
+
+   stable_sort(_cands.begin(), _cands.end(), CirCutCompFN());
+   for (size_t i = _limit, n = _cands.size(); i < n; i++)
+      _pool.free(_cands[i]);
+   if (_cands.size() > _limit) _cands.resize(_limit);
+
+   CirCut* last = triv;
+   for (size_t i = 0, n = _cands.size(); i < n; i++) {
+      last->_next = _cands[i];
+      last = _cands[i];
+   }
+   last->_next = 0;
+   return triv;
+}
+
+// union of the leaves; false if it exceeds k
+bool
+CirCutMgr::mergeCut(const CirCut* a, const CirCut* b, CirCut* c) const
+{
+   size_t i = 0, j = 0;
+   c->_size = 0;
+   while (i < a->_size || j < b->_size) {
+      if (c->_size == _k) return false;
+      if (j == b->_size || (i < a->_size && a->_leaves[i]->getID() < b->_leaves[j]->getID()))
+         c->_leaves[c->_size++] = a->_leaves[i++];
+      else if (i == a->_size || b->_leaves[j]->getID() < a->_leaves[i]->getID())
+         c->_leaves[c->_size++] = b->_leaves[j++];
+      else {
+         c->_leaves[c->_size++] = a->_leaves[i++];
+         j++;
+      }
+   }
+   c->_sign = a->_sign | b->_sign;
+   return true;
+}
+
+// if the leaves of a are a subset of those of b
+bool
+CirCutMgr::dominate(const CirCut* a, const CirCut* b) const
+{
+   if (a->_size > b->_size || (a->_sign & ~b->_sign)) return false;
+   for (size_t i = 0, j = 0; i < a->_size; i++, j++) {
+      while (j < b->_size && b->_leaves[j] != a->_leaves[i]) j++;
+      if (j == b->_size) return false;
+   }
+   return true;
+}
+
+// truth table of a cut over the leaves of a larger one (`to` contains
+// `from`); variables are moved up from the last one, so the place each
+// goes to is never in the support yet
+CirTruthWord
+CirCutMgr::stretchTruth(const CirCut* from, const CirCut* to) const
+{
+   CirTruthWord t = from->_truth;
+   size_t j = to->_size;
+   for (size_t i = from->_size; i > 0; i--) {
+      while (to->_leaves[--j] != from->_leaves[i - 1]) ;
+      if (j != i - 1) t = swapVars(t, i - 1, j);
+   }
+   return t;
+}
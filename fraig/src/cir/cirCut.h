@@ -0,0 +1,111 @@
+/****************************************************************************
+  FileName     [ cirCut.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define k-feasible cut enumeration ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_CUT_H
+#define CIR_CUT_H
+
+#include <vector>
+#include "cirDef.h"
+#include "cirGate.h"
+
+using namespace std;
+
+//------------------------------------------------------------------------
+//   A cut and its truth table
+//------------------------------------------------------------------------
+// The leaves are sorted by gate ID; leaf i is variable i of the truth
+// table, which is replicated over the whole word (i.e. k = 6 always), so
+// the low 2^k bits can be taken directly for a smaller k.
+struct CirCut
+{
+   CirCut*        _next;     // in the cut list of a gate, or the free list
+   CirTruthWord   _truth;
+   unsigned       _sign;     // OR of 1 << (ID % 32) of the leaves
+   unsigned       _size;
+   CirGate*       _leaves[1];   // allocated for k leaves
+
+   CirGate* getLeaf(size_t i) const { return _leaves[i]; }
+   unsigned getSize() const { return _size; }
+   CirTruthWord getTruth() const { return _truth; }
+   const CirCut* getNext() const { return _next; }
+};
+
+//------------------------------------------------------------------------
+//   Fixed size records allocated by pages
+//------------------------------------------------------------------------
+class CirCutPool
+{
+public:
+   CirCutPool(unsigned k, size_t pageSize = 4096);
+   ~CirCutPool() { reset(); }
+
+   CirCut* alloc();
+   void free(CirCut* c) { c->_next = _freeList; _freeList = c; _used--; }
+   void reset();
+
+   size_t getUsedCount() const { return _used; }
+   size_t getMemSize() const { return _pages.size() * _pageSize * _recSize; }
+
+private:
+   size_t           _recSize;
+   size_t           _pageSize;   // #records per page
+   vector<char*>    _pages;
+   size_t           _pageUsed;   // #records taken from the last page
+   CirCut*          _freeList;
+   size_t           _used;
+};
+
+//------------------------------------------------------------------------
+//   Priority cut enumeration
+//------------------------------------------------------------------------
+// The cut list of a gate starts with its trivial cut, followed by at most
+// _limit cuts merged from the lists of the fanins, smaller ones first and
+// then those over leaves of more fanouts. Dominated cuts are dropped.
+// The constant has a single empty cut. Lists are computed on demand, or
+// for a whole topological order with enumerate().
+class CirCutMgr
+{
+public:
+   CirCutMgr(unsigned k = CUT_SIZE, unsigned limit = CUT_PRIORITY);
+   ~CirCutMgr() {}
+
+   void enumerate(const GateList&);
+   const CirCut* getCuts(CirGate*);
+   bool hasCuts(CirGate* g) const {
+      return g->getID() < _cuts.size() && _cuts[g->getID()];
+   }
+   void removeCuts(CirGate*);
+   void reset();
+
+   // truth tables of two cuts over the union of their leaves;
+   // false if it has more than k leaves
+   bool mergeTruth(const CirCut*, const CirCut*, CirTruthWord&, CirTruthWord&);
+
+   unsigned getCutSize() const { return _k; }
+   unsigned getPriority() const { return _limit; }
+   size_t getCutCount() const { return _pool.getUsedCount(); }
+   size_t getMemSize() const {
+      return _pool.getMemSize() + _cuts.capacity() * sizeof(CirCut*);
+   }
+
+private:
+   unsigned          _k;
+   unsigned          _limit;
+   CirCutPool        _pool;
+   vector<CirCut*>   _cuts;     // by gate ID
+   vector<CirCut*>   _cands;    // of the gate being computed
+   GateList          _stack;    // gates to compute, after their fanins
+   CirCut*           _union;    // for mergeTruth(); taken on first use
+
+   CirCut* computeCuts(CirGate*);
+   bool mergeCut(const CirCut*, const CirCut*, CirCut*) const;
+   bool dominate(const CirCut*, const CirCut*) const;
+   CirTruthWord stretchTruth(const CirCut*, const CirCut*) const;
+};
+
+#endif // CIR_CUT_H
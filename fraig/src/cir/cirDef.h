@@ -20,6 +20,11 @@ using namespace std;
 class CirGate;
 class CirMgr;
 class SatSolver;
+class CirCutProver;
+class CirCutMgr;
+class CirFecStore;
+struct CirFraigStats;
+struct CirGenSpec;
 
 typedef size_t                     CirGateV;
 typedef vector<CirGate*>           GateList;
@@ -30,6 +35,15 @@ typedef map<unsigned, CirGate*>    GateMap;
 typedef unsigned                   CirSimData;
 
 typedef vector<GateList*>          FECGroupList;
+typedef unsigned long long         CirTruthWord;
+
+// an AIG line kept by "CIRRead -Strash" until initialize(); 0 if not defined
+struct CirAigDef
+{
+   CirAigDef(): _lineNo(0) { _fanin[0] = _fanin[1] = 0; }
+   unsigned _lineNo;
+   unsigned _fanin[2];   // literal IDs
+};
 
 const unsigned SIM_BITS          = sizeof(CirSimData) << 3;
 const CirSimData SIM_HIGHEST_BIT = (CirSimData)1 << (SIM_BITS - 1);
@@ -45,4 +59,41 @@ enum GateType
    TOT_GATE
 };
 
+// what the optimization, simulation and fraig commands print
+enum CirVerbosity
+{
+   CIR_VERB_NONE     = -1,  // nothing; for the cones fraiged in parallel
+   CIR_VERB_SUMMARY  = 0,   // a summary line per command
+   CIR_VERB_PROGRESS = 1,   // and the simulation progress, once a second
+   CIR_VERB_ITEM     = 2    // and every merge, removal, proof and block
+};
+
+// when to stop CIRSIMulate -Random; 0 stands for no limit
+struct CirSimEffort
+{
+   CirSimEffort(): _idle(0), _patterns(0), _seconds(0), _stats(false) {}
+   unsigned _idle;       // rounds without any refinement (0: the default rule)
+   unsigned _patterns;   // pattern budget
+   unsigned _seconds;    // CPU time budget
+   bool     _stats;      // report the statistics
+};
+
+enum FraigOrder
+{
+   FRAIG_ORDER_GROUP = 0,  // group by group, against the first member
+   FRAIG_ORDER_TOPO  = 1   // topological sweeping, merging as it goes
+};
+
+// leaves of the cuts checked before SAT in fraig (0: no cut checking),
+// at most CUT_MAX_SIZE
+const unsigned FRAIG_CUT_SIZE    = 4;   // default
+
+// fanout levels of the windows of the ODC redundancy removal
+const unsigned ODC_WINDOW        = 3;   // default
+
+// k-feasible cut enumeration; the truth tables are single words
+const unsigned CUT_MAX_SIZE      = 6;
+const unsigned CUT_SIZE          = 4;   // default k
+const unsigned CUT_PRIORITY      = 8;   // default #cuts kept per gate
+
 #endif // CIR_DEF_H
@@ -34,55 +34,141 @@ static void printFaninPair(CirGate* g) {
 }
 #endif  // VERBOSE && HASHMAP_DEBUG
 
+/*********************************************/
+/*   Member functions about cut based proof   */
+/*********************************************/
+// if every leaf is a free input, i.e. takes all the combinations
+static bool isFreeCut(const CirCut* c) {
+   for (size_t i = 0, n = c->getSize(); i < n; i++)
+      if (c->getLeaf(i)->isAig()) return false;
+   return true;
+}
+
+CirCutResult
+CirCutProver::prove(CirGate* x, CirGate* y, bool inv)
+{
+   assert(_cutMgr && x != 0 && x != y);
+
+   CirTruthWord mask = (inv ? ~(CirTruthWord)0 : 0);
+   bool equal = false, different = false;
+   const CirCut* cx = _cutMgr->getCuts(x);
+   const CirCut* cy = (y ? _cutMgr->getCuts(y) : 0);
+   for (const CirCut* a = cx; a && !equal; a = a->getNext()) {
+      if (!y) {
+         // the truth tables are replicated over the word
+         if (a->getTruth() == mask) equal = true;
+         else if (isFreeCut(a)) different = true;
+         continue;
+      }
+      for (const CirCut* b = cy; b && !equal; b = b->getNext()) {
+         CirTruthWord ta, tb;
+         if (!_cutMgr->mergeTruth(a, b, ta, tb)) continue;
+         if (ta == (tb ^ mask)) equal = true;
+         else if (isFreeCut(a) && isFreeCut(b)) different = true;
+      }
+   }
+
+   if (equal && !_refuteOnly) {
+      _equal++;
+      return CUT_EQUAL;
+   }
+   if (different) {
+      _different++;
+      return CUT_DIFFERENT;
+   }
+   _unknown++;
+   return CUT_UNKNOWN;
+}
+
+// g is to be merged away; the cuts over it are in its fanout cone. A gate
+// only has cuts if its fanins have, so the cone is cut off at the gates
+// without them
+void
+CirCutProver::removeGate(CirGate* g)
+{
+   if (!_cutMgr) return;
+   _cutMgr->removeCuts(g);
+   _stack.clear();
+   for (size_t i = 0, n = g->_fanoutList.size(); i < n; i++)
+      _stack.push_back(g->getFanout(i));
+   while (!_stack.empty()) {
+      CirGate* h = _stack.back();
+      _stack.pop_back();
+      if (!_cutMgr->hasCuts(h)) continue;
+      _cutMgr->removeCuts(h);
+      for (size_t i = 0, n = h->_fanoutList.size(); i < n; i++)
+         _stack.push_back(h->getFanout(i));
+   }
+}
+
 /*******************************************/
 /*   Public member functions about fraig   */
 /*******************************************/
 // _floatList may be changed.
 // _unusedList and _undefList won't be changed
+// The ANDs are hashed on the core, in node order, by their fanins after
+// the merges before them; the merges are then made on the gates in the
+// same order.
 void
 CirMgr::strash()
 {
-   getDfsList();
-
-   size_t dfsSize = _dfsList.size();
-
-   HashMap<CirStrashKey, CirGate*> hashStrash(getHashSize(dfsSize * 5 / 3));
+   CirPhaseScope prof(_profiler, PHASE_STRASH);
+   const CirAig& aig = getAig();
+
+   unsigned nNodes = aig.getNodeCount();
+   HashMap<CirStrashKey, unsigned> hashStrash(getHashSize(nNodes * 5 / 3));
+
+   // the literal each node is merged into; the nodes merged, and into what
+   IdList rep(nNodes), mergedNodes, mergedInto;
+   for (unsigned n = 0; n < nNodes; n++) rep[n] = 2 * n;
+   for (unsigned n = aig.getInputCount() + 1; n < nNodes; n++) {
+      unsigned f0 = aig.getFanin0(n), f1 = aig.getFanin1(n);
+      CirStrashKey k(rep[f0 >> 1] ^ (f0 & 1), rep[f1 >> 1] ^ (f1 & 1));
+      unsigned t = 0;
+      if (hashStrash.check(k, t)) {
+         rep[n] = 2 * t;
+         mergedNodes.push_back(n);
+         mergedInto.push_back(t);
+      } else {
+         hashStrash.forceInsert(k, n);
+      }
+   }
 
    #if defined(VERBOSE) && defined(HASHMAP_DEBUG)
    unsigned foundCount = 0;
    #endif  // VERBOSE && HASHMAP_DEBUG
+   unsigned merged = 0;
 
-   for (size_t i = 0; i < dfsSize; i++) {
-      if (!_dfsList[i]->isAig()) continue;
-      CirStrashKey k(_dfsList[i]);
-      CirGate* t = 0;
-
-      if (hashStrash.check(k, t)) {
+   for (size_t i = 0, m = mergedNodes.size(); i < m; i++) {
+      CirGate* g = getAigGate(mergedNodes[i]);
+      CirGate* t = getAigGate(mergedInto[i]);
 
-         // remove old gate from fanin's fanout
-         t->getFanin(0)->eraseFanout(_dfsList[i]);
-         t->getFanin(1)->eraseFanout(_dfsList[i]);
+      // remove old gate from fanin's fanout
+      t->getFanin(0)->eraseFanout(g);
+      t->getFanin(1)->eraseFanout(g);
 
-         mergeGate(t, _dfsList[i]);
+      mergeGate(t, g);
+      merged++;
 
-         cout << "Strashing: " << t->getID() << " merging " << _dfsList[i]->getID() << "...";
+      if (isVerbose()) {
+         cout << "Strashing: " << t->getID() << " merging " << g->getID() << "...";
 
          #if defined(VERBOSE) && defined(HASHMAP_DEBUG)
-         cout << " hash " << _dfsList[i]->getID() << " [";
-         printFaninPair(_dfsList[i]);
-         cout << "] (" << k() << ") == " << t->getID() << " [";
+         cout << " hash " << g->getID() << " [";
+         printFaninPair(g);
+         cout << "] == " << t->getID() << " [";
          printFaninPair(t);
          cout << "]";
          foundCount++;
          #endif  // VERBOSE && HASHMAP_DEBUG
 
          cout << endl;
-
-         eraseGate(_dfsList[i]);
-      } else {
-         hashStrash.forceInsert(k, _dfsList[i]);
       }
+
+      eraseGate(g);
    }
+   if (!isVerbose() && !isSilent())
+      cout << "Strashing: " << merged << " AIGs merged" << endl;
 
    #ifdef CHECK_INTEGRITY
    checkIntegrity();
@@ -98,8 +184,10 @@ CirMgr::strash()
 }
 
 void CirMgr::genProofModel(SatSolver& s) {
+   CirPhaseScope prof(_profiler, PHASE_CNF);
    GateList& l = getDfsList();
 
+   bool hasConst = false;
    for (size_t i = 0, n = l.size(); i < n; i++) {
       l[i]->dfsListIdx = i;
       l[i]->_satVar = s.newVar();
@@ -109,13 +197,37 @@ void CirMgr::genProofModel(SatSolver& s) {
             l[i]->getFanin(0)->_satVar, l[i]->getInv(0),
             l[i]->getFanin(1)->_satVar, l[i]->getInv(1)
          );
-      }
+      } else if (l[i] == _gates[0]) hasConst = true;
    }
 
-   // constraint for the constant gate
+   // constraint for the constant gate; it heads the constant FEC group
+   // even when no PO reaches it
+   if (!hasConst) _gates[0]->_satVar = s.newVar();
    s.assertProperty(_gates[0]->_satVar, false);
 }
 
+// shrink the proof model before fraig;
+// only gates in FEC groups are ever referred to by satProve() or getValue(),
+// so everything else may be eliminated
+void CirMgr::preprocessProofModel(SatSolver& s) {
+   CirPhaseScope prof(_profiler, PHASE_CNF);
+   s.setFrozen(_gates[0]->_satVar);
+   for (size_t i = 0, n = _fecGroupList->size(); i < n; i++) {
+      GateList& gl = *_fecGroupList->at(i);
+      for (size_t j = 0, m = gl.size(); j < m; j++)
+         s.setFrozen(gl[j]->_satVar);
+   }
+
+   s.preprocess();
+
+   const SimpStats& st = s.getSimpStats();
+   if (isSilent()) return;
+   cout << "Preprocess: " << st.eliminated_vars << " vars eliminated, "
+        << st.subsumed_clauses << " subsumed, "
+        << st.strengthened_clauses << " strengthened; clauses "
+        << st.clauses_before << " -> " << st.clauses_after << endl;
+}
+
 static bool fecGroupListCompFN(GateList* a, GateList* b) {
    GateList& la = *a;
    GateList& lb = *b;
@@ -125,12 +237,42 @@ static bool fecGroupListCompFN(GateList* a, GateList* b) {
    return (la[ia]->dfsListIdx < lb[ib]->dfsListIdx);
 }
 
+// the constant gate first, then by DFS index
+static bool fecGateCompFN(CirGate* a, CirGate* b) {
+   if (a->getID() == 0 || b->getID() == 0)
+      return (a->getID() == 0 && b->getID() != 0);
+   return (a->dfsListIdx < b->dfsListIdx);
+}
+
+// whether b is in the fanin cone of a; the DFS indices are not used to
+// prune it, since they are stale after the merges before; the gates seen
+// are marked
+static bool inFaninCone(const CirGate* a, const CirGate* b) {
+   vector<const CirGate*> stack(1, a);
+   a->mark();
+   while (!stack.empty()) {
+      const CirGate* g = stack.back();
+      stack.pop_back();
+      if (g == b) return true;
+      if (!g->isAig()) continue;
+      for (size_t j = 0; j < 2; j++) {
+         const CirGate* f = g->getFanin(j);
+         if (f->isMarked()) continue;
+         f->mark();
+         stack.push_back(f);
+      }
+   }
+   return false;
+}
+
 // use given SAT engine to prove (phase ? x == !y : x == y)
 // returns if the assumption is satisifiable
 // if y != 0, prove (x, y) pair
 // if y == 0, prove x against const
-static bool satProve(SatSolver& s, CirGate* x, CirGate* y, bool phase) {
+static bool satProve(SatSolver& s, CirGate* x, CirGate* y, bool phase,
+                     CirProfiler& prof) {
    assert(x != 0);
+   CirPhaseScope scope(prof, PHASE_SAT);
 
    s.assumeRelease();
    if (y) {
@@ -144,17 +286,85 @@ static bool satProve(SatSolver& s, CirGate* x, CirGate* y, bool phase) {
 }
 
 void
-CirMgr::fraig()
+CirMgr::fraig(bool preprocess, FraigOrder order, unsigned cutSize,
+              const string& dratName)
 {
    assert(_fecGroupList);
 
+   // a preprocessed model only fits the FEC groups it was frozen for;
+   // a DRAT proof needs every clause of the model written with it
+   if ((preprocess || !dratName.empty()) && _satSolver) {
+      delete _satSolver;
+      _satSolver = 0;
+   }
+
+   DratWriter* drat = 0;
    if (!_satSolver) {
       _satSolver = new SatSolver();
       _satSolver->initialize();
+      if (!dratName.empty()) {
+         drat = new DratWriter((dratName + ".drat").c_str());
+         _satSolver->recordCnf();
+         _satSolver->setDrat(drat);
+      }
       genProofModel(*_satSolver);
+      if (preprocess)
+         preprocessProofModel(*_satSolver);
    }
 
-   SatSolver& s = *_satSolver;
+   // a merge by the cuts would have no lemmas in the proof
+   CirCutProver cut(cutSize);
+   if (drat) cut.setRefuteOnly();
+   CirFraigStats stats;
+   unsigned aigs = _andGateCount;
+   if (order == FRAIG_ORDER_TOPO)
+      fraigTopo(*_satSolver, cut, stats);
+   else
+      fraigGroup(*_satSolver, cut, stats);
+
+   if (cutSize && !isSilent())
+      cout << "Fraig: " << cut.getEqualCount() << " proven and "
+           << cut.getDifferentCount() << " refuted by " << cutSize << "-cuts, "
+           << cut.getUnknownCount() << " left to SAT" << endl;
+
+   // clean up floating gates
+   sweep();
+
+   if (!isVerbose() && !isSilent())
+      cout << "Fraig: " << aigs << " -> " << _andGateCount << " AIGs; "
+           << stats._unsat << " merged, " << stats._sat << " refuted" << endl;
+
+   // invalidate all FEC group lists
+   for (GateMap::iterator it = _gates.begin(); it != _gates.end(); ++it)
+      (*it).second->_fecGroup = 0;
+   for (size_t i = 0, n = _fecGroupList->size(); i < n; i++)
+      delete _fecGroupList->at(i);
+   delete _fecGroupList;
+   _fecGroupList = 0;
+
+   // the proof refers to the clauses given so far, and to no later ones
+   if (drat) {
+      _satSolver->setDrat(0);
+      if (!_satSolver->writeCnf((dratName + ".cnf").c_str()))
+         cerr << "Error: cannot write \"" << dratName << ".cnf\"!!" << endl;
+      else if (!isSilent())
+         cout << "Fraig: proof written to \"" << dratName << ".drat\" for \""
+              << dratName << ".cnf\" (" << drat->added << " lemmas)" << endl;
+      delete drat;
+   }
+
+   // eliminated variables may belong to the next FEC groups
+   if (preprocess || !dratName.empty()) {
+      delete _satSolver;
+      _satSolver = 0;
+   }
+}
+
+/********************************************/
+/*   Private member functions about fraig   */
+/********************************************/
+// prove the FEC groups one by one, every member against the first one
+void CirMgr::fraigGroup(SatSolver& s, CirCutProver& cut, CirFraigStats& stats) {
 
    // size_t piSize = _piList.size();
    // CirSimData cexPool[piSize];
@@ -168,7 +378,8 @@ CirMgr::fraig()
 
    for (size_t i = 0, n = _fecGroupList->size(); i < n; i++) {
       GateList* gl = _fecGroupList->at(i);
-      cout << "FEC Group #" << i << " / " << (n - i) << ", len = " << gl->size() << " ------" << endl;
+      if (isVerbose())
+         cout << "FEC Group #" << i << " / " << (n - i) << ", len = " << gl->size() << " ------" << endl;
 
       bool halt = false;
 
@@ -179,13 +390,17 @@ CirMgr::fraig()
             // constant SAT
             if (gx == constGate) continue;
             bool cond = (gx->getSimData() == 0);
-            cout << "  Proving " << (gx->getID()) << " = " << (cond ? 1 : 0) << "... ";
+            if (isVerbose())
+               cout << "  Proving " << (gx->getID()) << " = " << (cond ? 1 : 0) << "... ";
 
-            bool result = satProve(s, gx, 0, cond);
+            CirCutResult r = (cut.getCutSize() ? cut.prove(gx, 0, !cond) : CUT_UNKNOWN);
+            bool result = (r == CUT_UNKNOWN ? satProve(s, gx, 0, cond, _profiler) : r == CUT_DIFFERENT);
 
-            cout << (result ? "SAT" : "UNSAT") << "!!" << endl;
+            if (isVerbose())
+               cout << (result ? "SAT" : "UNSAT") << "!!" << endl;
             if (result) {
                // SAT
+               stats._sat++;
                if (m > 2) {
                   // use CEX to separate this list!
                   // because it only diverges to 0 and 1
@@ -220,15 +435,18 @@ CirMgr::fraig()
                }
             } else {
                // UNSAT
+               stats._unsat++;
+               cut.removeGate(gx);
                gx->getFanin(0)->eraseFanout(gx);
                gx->getFanin(1)->eraseFanout(gx);
 
-               cout << "Fraig: " << (cond ? "" : "!") << "0 merging " << gx->getID() << endl;
+               if (isVerbose())
+                  cout << "Fraig: " << (cond ? "" : "!") << "0 merging " << gx->getID() << endl;
 
-               // CHECK: is the phase correct?
                for (size_t i = 0, n = gx->_fanoutList.size(); i < n; i++) {
-                  gx->getFanout(i)->replaceFanin(gx, (CirGateV)constGate | cond);
-                  constGate->addFanout((CirGateV)gx->getFanout(i) | cond);
+                  bool inv = gx->getFanoutInv(i) ^ !cond;
+                  gx->getFanout(i)->replaceFanin(gx, (CirGateV)constGate | !cond);
+                  constGate->addFanout((CirGateV)gx->getFanout(i) | inv);
                }
                eraseGate(gx);
             }
@@ -239,11 +457,17 @@ CirMgr::fraig()
                if (!gy) continue;
 
                bool inv = (gx->getSimData() != gy->getSimData());
-               cout << "  Proving (" << (gx->getID()) << ", " << (inv ? "!" : "") << (gy->getID()) << ")... ";
-               bool result = satProve(s, gx, gy, inv);
+               if (isVerbose())
+                  cout << "  Proving (" << (gx->getID()) << ", " << (inv ? "!" : "") << (gy->getID()) << ")... ";
+               CirCutResult r = (cut.getCutSize() ? cut.prove(gx, gy, inv) : CUT_UNKNOWN);
+               bool result = (r == CUT_UNKNOWN ? satProve(s, gx, gy, inv, _profiler) : r == CUT_DIFFERENT);
 
-               cout << (result ? "SAT" : "UNSAT") << "!!" << endl;
+               if (isVerbose())
+                  cout << (result ? "SAT" : "UNSAT") << "!!" << endl;
                if (result) {
+                  stats._sat++;
+                  // no model to split the group with; go on with the rest
+                  if (r == CUT_DIFFERENT) continue;
                   // SAT
                   // bool failed = false;
                   // for (size_t i = 0, n = piSize; i < n; ++i) {
@@ -303,11 +527,20 @@ CirMgr::fraig()
                } else {
                   // UNSAT
                   // discard this gate; may produce floating gates
+                  stats._unsat++;
+                  // merging into a gate in its own fanout cone closes a loop
+                  CirGate::clearMark();
+                  if (inFaninCone(gx, gy)) {
+                     gl->at(x) = gy;
+                     swap(gx, gy);
+                  }
+                  cut.removeGate(gy);
                   gy->getFanin(0)->eraseFanout(gy);
                   gy->getFanin(1)->eraseFanout(gy);
 
-                  mergeGate(gx, gy);
-                  cout << "Fraig: " << gx->getID() << " merging " << (inv ? "!" : "") << gy->getID() << endl;
+                  mergeGate(gx, gy, inv);
+                  if (isVerbose())
+                     cout << "Fraig: " << gx->getID() << " merging " << (inv ? "!" : "") << gy->getID() << endl;
                   eraseGate(gy);
                   gl->at(y) = 0;
                }
@@ -351,33 +584,118 @@ CirMgr::fraig()
       //    bit = SIM_HIGHEST_BIT;
       // }
    }
+}
 
+// sweep the candidates in topological order, proving each one against the
+// representative of its FEC group (the constant gate, or else the member
+// with the smallest DFS index) and merging it right away; the proven
+// equivalence is added to the proof model to help the later proofs, as
+// lemmas of the DRAT proof if any
+void CirMgr::fraigTopo(SatSolver& s, CirCutProver& cut, CirFraigStats& stats) {
+   CirGate* constGate = _gates[0];
 
+   GateList cands;
+   for (size_t i = 0, n = _fecGroupList->size(); i < n; i++) {
+      GateList& gl = *_fecGroupList->at(i);
+      sort(gl.begin(), gl.end(), fecGateCompFN);
+      cands.insert(cands.end(), gl.begin() + 1, gl.end());
+   }
+   sort(cands.begin(), cands.end(), fecGateCompFN);
+
+   for (size_t i = 0, n = cands.size(); i < n; i++) {
+      CirGate* g = cands[i];
+      GateList* gl = g->_fecGroup;
+      if (!gl || gl->at(0) == g) continue;
+      CirGate* rep = gl->at(0);
+
+      bool inv = (rep->getSimData() != g->getSimData());
+      bool result;
+      CirCutResult r = CUT_UNKNOWN;
+      if (rep == constGate) {
+         if (isVerbose())
+            cout << "  Proving " << g->getID() << " = " << (inv ? 0 : 1) << "... ";
+         if (cut.getCutSize()) r = cut.prove(g, 0, inv);
+         result = (r == CUT_UNKNOWN ? satProve(s, g, 0, !inv, _profiler) : r == CUT_DIFFERENT);
+      } else {
+         if (isVerbose())
+            cout << "  Proving (" << rep->getID() << ", " << (inv ? "!" : "") << g->getID() << ")... ";
+         if (cut.getCutSize()) r = cut.prove(rep, g, inv);
+         result = (r == CUT_UNKNOWN ? satProve(s, rep, g, inv, _profiler) : r == CUT_DIFFERENT);
+      }
+      if (isVerbose())
+         cout << (result ? "SAT" : "UNSAT") << "!!" << endl;
+
+      if (result) {
+         stats._sat++;
+         // a refutation by the cut has no model to refine with
+         if (r == CUT_UNKNOWN) refineFECGroups(s);
+         continue;
+      }
 
-   // clean up floating gates
-   sweep();
+      // UNSAT: g == (inv ? !rep : rep)
+      gl->erase(find(gl->begin(), gl->end(), g));
+      if (gl->size() < 2) rep->_fecGroup = 0;
+      s.addEqLemma(rep->_satVar, g->_satVar, inv);
+
+      cut.removeGate(g);
+      g->getFanin(0)->eraseFanout(g);
+      g->getFanin(1)->eraseFanout(g);
+      mergeGate(rep, g, inv);
+      stats._unsat++;
+      if (isVerbose()) {
+         if (rep == constGate)
+            cout << "Fraig: " << (inv ? "!" : "") << "0 merging " << g->getID() << endl;
+         else
+            cout << "Fraig: " << rep->getID() << " merging " << (inv ? "!" : "") << g->getID() << endl;
+      }
+      eraseGate(g);
+   }
+}
 
-   // invalidate all FEC group lists
-   for (GateMap::iterator it = _gates.begin(); it != _gates.end(); ++it)
-      (*it).second->_fecGroup = 0;
-   for (size_t i = 0, n = _fecGroupList->size(); i < n; i++)
-      delete _fecGroupList->at(i);
-   delete _fecGroupList;
-   _fecGroupList = 0;
+// split every FEC group by the values of the last satisfying assignment;
+// the member order (hence the representative) of each part is kept
+void CirMgr::refineFECGroups(SatSolver& s) {
+   for (size_t i = 0, n = _fecGroupList->size(); i < n; i++) {
+      GateList& gl = *_fecGroupList->at(i);
+      if (gl.size() < 2) continue;
+
+      CirSimData refSimData = gl[0]->getSimData();
+      bool refVal = (s.getValue(gl[0]->_satVar) == 1);
+      GateList* vSeparate = new GateList;
+      size_t cnt = 1;
+      for (size_t j = 1, m = gl.size(); j < m; j++) {
+         bool val = (s.getValue(gl[j]->_satVar) == 1);
+         bool valExpect = (gl[j]->getSimData() == refSimData);
+         if (valExpect == (val == refVal))
+            gl[cnt++] = gl[j];
+         else
+            vSeparate->push_back(gl[j]);
+      }
+      gl.resize(cnt);
+
+      if (cnt < 2) gl[0]->_fecGroup = 0;
+      if (vSeparate->size() >= 2) {
+         for (size_t j = 0, m = vSeparate->size(); j < m; j++)
+            vSeparate->at(j)->_fecGroup = vSeparate;
+         _fecGroupList->push_back(vSeparate);
+      } else {
+         if (vSeparate->size()) vSeparate->at(0)->_fecGroup = 0;
+         delete vSeparate;
+      }
+   }
 }
 
-/********************************************/
-/*   Private member functions about fraig   */
-/********************************************/
 // merge `mergeFrom` to `mergeTo`
 // after this operation, src become floating
 // but simply calling this method is not enough
 // fanins of `mergeTo` need to be purged(?)
-void CirMgr::mergeGate(CirGate* mergeTo, CirGate* mergeFrom) {
+// `inv` tells if `mergeFrom` is the complement of `mergeTo`
+void CirMgr::mergeGate(CirGate* mergeTo, CirGate* mergeFrom, bool inv) {
    _dfsList_clean = false;
 
    for (size_t i = 0, n = mergeFrom->_fanoutList.size(); i < n; i++) {
-      mergeFrom->getFanout(i)->replaceFanin(mergeFrom, (CirGateV)mergeTo | mergeFrom->getFanoutInv(i));
-      mergeTo->addFanout(mergeFrom->_fanoutList[i]);
+      bool foInv = mergeFrom->getFanoutInv(i) ^ inv;
+      mergeFrom->getFanout(i)->replaceFanin(mergeFrom, (CirGateV)mergeTo | inv);
+      mergeTo->addFanout((CirGateV)mergeFrom->getFanout(i) | foInv);
    }
 }
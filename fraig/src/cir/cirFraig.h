@@ -0,0 +1,73 @@
+/****************************************************************************
+  FileName     [ cirFraig.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define helpers for cir FRAIG ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2012-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_FRAIG_H
+#define CIR_FRAIG_H
+
+#include <vector>
+#include "cirDef.h"
+#include "cirCut.h"
+
+using namespace std;
+
+enum CirCutResult
+{
+   CUT_UNKNOWN   = 0,  // leave it to SAT
+   CUT_EQUAL     = 1,  // proven equivalent
+   CUT_DIFFERENT = 2   // refuted (the cut only has free inputs)
+};
+
+// outcomes of the proofs of a fraig run, for the summary
+struct CirFraigStats
+{
+   CirFraigStats(): _sat(0), _unsat(0) {}
+   unsigned _sat;     // refuted
+   unsigned _unsat;   // proven, then merged
+};
+
+//------------------------------------------------------------------------
+//   Decide FEC pairs by truth tables over small cuts
+//------------------------------------------------------------------------
+// The priority cuts of both gates are enumerated by a CirCutMgr; a pair
+// of them within k leaves together gives the truth tables of the gates
+// over the same leaves, so equal ones prove the pair. Different ones only
+// refute it if every leaf is a free input (PI or undefined), since
+// internal leaves may not take all the combinations.
+// The cuts of a gate about to be merged away are removed with those of
+// its fanout cone, which may have it as a leaf.
+class CirCutProver
+{
+public:
+   CirCutProver(unsigned k = FRAIG_CUT_SIZE):
+      _cutMgr(k ? new CirCutMgr(k) : 0), _refuteOnly(false),
+      _equal(0), _different(0), _unknown(0) {}
+   ~CirCutProver() { delete _cutMgr; }
+
+   unsigned getCutSize() const { return _cutMgr ? _cutMgr->getCutSize() : 0; }
+   // leave the equal pairs to SAT too, e.g. for a proof of every merge
+   void setRefuteOnly(bool b = true) { _refuteOnly = b; }
+
+   // prove x == (inv ? !y : y); y == 0 stands for the constant 0
+   CirCutResult prove(CirGate* x, CirGate* y, bool inv);
+   void removeGate(CirGate*);
+
+   unsigned getEqualCount() const { return _equal; }
+   unsigned getDifferentCount() const { return _different; }
+   unsigned getUnknownCount() const { return _unknown; }
+
+private:
+   CirCutMgr*              _cutMgr;
+   bool                    _refuteOnly;
+   GateList                _stack;   // for removeGate()
+
+   unsigned                _equal;
+   unsigned                _different;
+   unsigned                _unknown;
+};
+
+#endif // CIR_FRAIG_H
@@ -23,15 +23,17 @@ using namespace std;
 
 extern CirMgr *cirMgr;
 
-unsigned CirGate::_global_ref = 0;
+__thread unsigned CirGate::_global_ref = 0;
+unsigned CirGate::_ref_count = 0;
 
 /**************************************/
 /*   class CirGate member functions   */
 /**************************************/
+// a becomes b; each fanin of a keeps its own phase, as in (a, !a)
 void CirGate::replaceFanin(CirGate* a, CirGateV b) {
    for (size_t i = 0; i < _faninCount; i++) {
       if (getFanin(i) == a) {
-         setFanin(i, b);
+         setFanin(i, b ^ getInv(i));
       }
    }
 }
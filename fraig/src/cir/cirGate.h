@@ -32,7 +32,8 @@ class CirGate
 
 public:
    CirGate(GateType t = UNDEF_GATE, unsigned gid = 0, int ln = 0):
-      _type(t), _faninCount(0), _fecGroup(0), _id(gid), _ref(_global_ref), _lineno(ln), _sim_data(0) {}
+      _type(t), _faninCount(0), _fecGroup(0), dfsListIdx(0), _satVar(0), _id(gid), _ref(_global_ref),
+      _lineno(ln), _sim_data(0) {}
    virtual ~CirGate() {}
 
    GateType _type;
@@ -98,21 +99,34 @@ public:
    void reportFaninRecursive(int) const;
    void reportFanoutRecursive(int) const;
 
-   virtual bool isAig() const { return false; }
+   // by the type, not to be dispatched in the hot loops
+   bool isAig() const { return _type == AIG_GATE; }
 
-   virtual void simulate() {}
-   CirSimData getSimData(bool inv = false) const { return (inv ? ~_sim_data : _sim_data); }
+   // only the AIGs and the POs take the values of their fanins
+   void simulate() {
+      if (_type == AIG_GATE)
+         _sim_data = getFaninSimData(0) & getFaninSimData(1);
+      else if (_type == PO_GATE)
+         _sim_data = getFaninSimData(0);
+   }
+   CirSimData getSimData(bool inv = false) const { return _sim_data ^ -(CirSimData)inv; }
+   CirSimData getFaninSimData(size_t i) const {
+      return getFanin(i)->_sim_data ^ -(CirSimData)getInv(i);
+   }
    void setSimData(CirSimData s) { _sim_data = s; }
 
    static unsigned const getGlobalRef() { return _global_ref; }
-   static void clearMark() { _global_ref++; }
+   // a value no thread has used, so that the marks of a thread on its own
+   // circuit are never taken for those of another
+   static void clearMark() { _global_ref = __sync_add_and_fetch(&_ref_count, 1); }
 
 private:
    unsigned         _id;
    mutable unsigned _ref;
    int              _lineno;
 
-   static unsigned _global_ref;
+   static __thread unsigned _global_ref;   // by thread
+   static unsigned _ref_count;
    static CirGateV const PTR_MASK = ~((CirGateV)1);
 
 protected:
@@ -136,14 +150,6 @@ public:
       cout << getFanin(1)->getID();
    }
 
-   bool isAig() const { return true; }
-   void simulate() {
-      assert(_faninCount == 2);
-      CirSimData sim1 = getFanin(0)->getSimData(getInv(0));
-      CirSimData sim2 = getFanin(1)->getSimData(getInv(1));
-      _sim_data = sim1 & sim2;
-   }
-
 private:
 };
 
@@ -189,10 +195,6 @@ public:
       if (getInv(0)) cout << "!";
       cout << getFanin(0)->getID();
    }
-
-   void simulate() {
-      _sim_data = getFanin(0)->getSimData(getInv(0));
-   }
 private:
 };
 
@@ -225,6 +227,20 @@ public:
       // use + to cause _v1 to overflow, prevent collision even more
       _hash = ((_v0 << 16) + _v1);
    };
+   // for the fanins of an AIG not yet created
+   CirStrashKey(CirGate* g0, bool i0, CirGate* g1, bool i1) {
+      _v0 = g0->getID() << 1 | i0;
+      _v1 = g1->getID() << 1 | i1;
+      if (_v0 > _v1) swap(_v0, _v1);
+      _hash = ((_v0 << 16) + _v1);
+   }
+   // for the fanin literals of an AND of the core
+   CirStrashKey(unsigned lit0, unsigned lit1) {
+      _v0 = lit0;
+      _v1 = lit1;
+      if (_v0 > _v1) swap(_v0, _v1);
+      _hash = ((_v0 << 16) + _v1);
+   }
    ~CirStrashKey() {}
    size_t operator() () const { return _hash; }
    bool operator == (const CirStrashKey& k) const { return _v0 == k._v0 && _v1 == k._v1; }
@@ -0,0 +1,297 @@
+/****************************************************************************
+  FileName     [ cirGen.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the synthetic circuit generator ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include "cirMgr.h"
+#include "cirGate.h"
+#include "cirGen.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// the largest variable such that the IDs of the POs still fit
+static const unsigned genMaxVar = 0x7FFFFFFF;
+
+// the partial products of each row are added to the sum so far by a
+// ripple carry adder; the 2n bits of the product are the POs
+static void genMultiplier(CirAigBuilder& b, unsigned n)
+{
+   IdList x(n), y(n), acc(2 * n, 0);
+   for (unsigned i = 0; i < n; i++) x[i] = b.newPI();
+   for (unsigned i = 0; i < n; i++) y[i] = b.newPI();
+
+   for (unsigned j = 0; j < n; j++)
+      acc[j] = b.andOf(x[j], y[0]);
+   for (unsigned i = 1; i < n; i++) {
+      unsigned c = 0;
+      for (unsigned j = 0; j < n; j++) {
+         unsigned p = b.andOf(x[j], y[i]);
+         unsigned s = acc[i + j];
+         unsigned t = b.xorOf(s, p);
+         acc[i + j] = b.xorOf(t, c);
+         c = b.orOf(b.andOf(s, p), b.andOf(t, c));
+      }
+      acc[i + n] = c;
+   }
+   for (unsigned k = 0; k < 2 * n; k++)
+      b.addPO(acc[k]);
+}
+
+// Sklansky prefix adder: log(n) levels of (generate, propagate) pairs;
+// the n sum bits and the carry out are the POs
+static void genAdder(CirAigBuilder& b, unsigned n)
+{
+   IdList x(n), y(n), p(n), g(n), pp(n);
+   for (unsigned i = 0; i < n; i++) x[i] = b.newPI();
+   for (unsigned i = 0; i < n; i++) y[i] = b.newPI();
+
+   for (unsigned i = 0; i < n; i++) {
+      g[i] = b.andOf(x[i], y[i]);
+      pp[i] = p[i] = b.xorOf(x[i], y[i]);
+   }
+   // (g, pp)[i] of bits (i & ~(2d - 1)) .. i at the end of level d
+   for (unsigned d = 1; d < n; d <<= 1)
+      for (unsigned i = 0; i < n; i++) {
+         if (!(i & d)) continue;
+         unsigned j = (i & ~(2 * d - 1)) + d - 1;
+         g[i] = b.orOf(g[i], b.andOf(pp[i], g[j]));
+         pp[i] = b.andOf(pp[i], pp[j]);
+      }
+
+   b.addPO(p[0]);
+   for (unsigned i = 1; i < n; i++)
+      b.addPO(b.xorOf(p[i], g[i - 1]));
+   b.addPO(g[n - 1]);
+}
+
+// the ANDs are spread evenly over the levels; the first fanin of each
+// one is from the level below, so the depth is as given, and the other
+// one is from anywhere below. The ANDs without fanouts are the POs.
+static void genRandom(CirAigBuilder& b, const CirGenSpec& spec)
+{
+   unsigned nIn = std::max(spec._inputs, 2u);
+   unsigned depth = std::max(std::min(spec._depth, spec._ands), 1u);
+   IdList below, prev, cur, popular;
+   for (unsigned i = 0; i < nIn; i++)
+      prev.push_back(b.newPI() / 2);
+   below = prev;
+
+   for (unsigned l = 0; l < depth; l++) {
+      unsigned n = spec._ands / depth + (l < spec._ands % depth ? 1 : 0);
+      cur.clear();
+      for (unsigned k = 0; k < n; k++) {
+         unsigned v0 = prev[b.random(prev.size())];
+         unsigned v1;
+         if (spec._fanout == GEN_FANOUT_POWER && !popular.empty() && b.random(2))
+            v1 = popular[b.random(popular.size())];
+         else v1 = below[b.random(below.size())];
+         if (v1 == v0) v1 = (v0 == below[0] ? below[1] : below[0]);
+         if (spec._fanout == GEN_FANOUT_POWER) {
+            popular.push_back(v0);
+            popular.push_back(v1);
+         }
+         cur.push_back(b.andOf(2 * v0 + b.random(2), 2 * v1 + b.random(2)) / 2);
+      }
+      below.insert(below.end(), cur.begin(), cur.end());
+      prev.swap(cur);
+   }
+
+   for (size_t i = nIn, n = below.size(); i < n; i++)
+      if (!b.getFanoutCount(below[i])) b.addPO(2 * below[i]);
+}
+
+/*******************************************/
+/*   class CirAigBuilder member functions  */
+/*******************************************/
+CirAigBuilder::CirAigBuilder(unsigned seed, unsigned redundancy):
+   _inputs(0), _redundancy(redundancy), _copies(0),
+   _rand(seed * 2654435761ULL + 88172645463325252ULL)
+{
+   // the constant
+   _fanin0.push_back(0);
+   _fanin1.push_back(0);
+   _fanouts.push_back(0);
+   _copy.push_back(0);
+   _turn.push_back(0);
+}
+
+unsigned
+CirAigBuilder::newPI()
+{
+   // the inputs must come first
+   assert(_fanin0.size() == _inputs + 1);
+   _inputs++;
+   _fanin0.push_back(0);
+   _fanin1.push_back(0);
+   _fanouts.push_back(0);
+   _copy.push_back(0);
+   _turn.push_back(0);
+   return _inputs * 2;
+}
+
+// with the trivial cases folded
+unsigned
+CirAigBuilder::andOf(unsigned a, unsigned b)
+{
+   a = use(a);
+   b = use(b);
+   if (a == 0 || b == 0 || a == (b ^ 1)) return 0;
+   if (a == 1 || a == b) return b;
+   if (b == 1) return a;
+   unsigned x = newAnd(a, b);
+   if (_redundancy && random(100) < _redundancy) plantCopy(x / 2);
+   return x;
+}
+
+unsigned
+CirAigBuilder::xorOf(unsigned a, unsigned b)
+{
+   return andOf(andOf(a, b) ^ 1, andOf(a ^ 1, b ^ 1) ^ 1);
+}
+
+// xorshift64*
+unsigned
+CirAigBuilder::random(unsigned range)
+{
+   _rand ^= _rand >> 12;
+   _rand ^= _rand << 25;
+   _rand ^= _rand >> 27;
+   return (unsigned)((_rand * 2685821657736338717ULL) >> 32) % range;
+}
+
+bool
+CirAigBuilder::load(CirMgr& mgr) const
+{
+   // the live ANDs; fanins always have smaller variables
+   size_t nVars = _fanin0.size();
+   vector<char> live(nVars, 0);
+   for (size_t i = 0, n = _pos.size(); i < n; i++)
+      live[_pos[i] / 2] = 1;
+   for (size_t v = nVars - 1; v > _inputs; v--)
+      if (live[v]) live[_fanin0[v] / 2] = live[_fanin1[v] / 2] = 1;
+
+   IdList id(nVars, 0);
+   unsigned nAnds = 0;
+   for (size_t v = 1; v < nVars; v++)
+      if (v <= _inputs) id[v] = v;
+      else if (live[v]) id[v] = _inputs + ++nAnds;
+   if ((unsigned long long)_inputs + nAnds + _pos.size() > genMaxVar)
+      return false;
+
+   mgr._maxNum = _inputs + nAnds;
+   mgr._inputCount = _inputs;
+   mgr._latchCount = 0;
+   mgr._outputCount = _pos.size();
+   mgr._andGateCount = nAnds;
+   mgr._gates[0] = new ConstGate();
+   mgr._piList.reserve(_inputs);
+   mgr._poList.reserve(_pos.size());
+
+   // line numbers as in the file to be written
+   int lineNo = 2;
+   for (unsigned v = 1; v <= _inputs; v++)
+      mgr.addPI(lineNo++, 2 * v);
+   for (size_t i = 0, n = _pos.size(); i < n; i++)
+      mgr.addPO(lineNo++, 2 * id[_pos[i] / 2] + (_pos[i] & 1));
+   for (size_t v = _inputs + 1; v < nVars; v++) {
+      if (!live[v]) continue;
+      mgr.addAIG(lineNo++, 2 * id[v],
+                 2 * id[_fanin0[v] / 2] + (_fanin0[v] & 1),
+                 2 * id[_fanin1[v] / 2] + (_fanin1[v] & 1));
+   }
+   mgr.initialize();
+   return true;
+}
+
+/*************************************************/
+/*   Private member functions of CirAigBuilder   */
+/*************************************************/
+// the uses of an AND with a copy alternate between the two
+unsigned
+CirAigBuilder::use(unsigned lit)
+{
+   unsigned v = lit / 2;
+   if (!_copy[v]) return lit;
+   _turn[v] ^= 1;
+   return (_turn[v] ? lit : _copy[v] ^ (lit & 1));
+}
+
+unsigned
+CirAigBuilder::newAnd(unsigned a, unsigned b)
+{
+   _fanin0.push_back(a);
+   _fanin1.push_back(b);
+   _fanouts.push_back(0);
+   _copy.push_back(0);
+   _turn.push_back(0);
+   _fanouts[a / 2]++;
+   _fanouts[b / 2]++;
+   return (_fanin0.size() - 1) * 2;
+}
+
+// a & b == (a & (b & c)) | (a & (b & !c)), for c other than a and b
+void
+CirAigBuilder::plantCopy(unsigned x)
+{
+   unsigned a = _fanin0[x], b = _fanin1[x];
+   unsigned c = 0;
+   for (unsigned k = 0; k < 4 && !c; k++) {
+      c = 1 + random(x - 1);
+      if (c == a / 2 || c == b / 2) c = 0;
+   }
+   if (!c) return;
+   c = 2 * c + random(2);
+   unsigned t1 = newAnd(a, newAnd(b, c));
+   unsigned t2 = newAnd(a, newAnd(b, c ^ 1));
+   _copy[x] = newAnd(t1 ^ 1, t2 ^ 1) ^ 1;
+   _copies++;
+}
+
+/*****************************************/
+/*   Public member functions of CirMgr   */
+/*****************************************/
+bool
+CirMgr::generate(const CirGenSpec& spec)
+{
+   // Output Example:
+   // Generated: multiplier 8x8; 16 PIs, 16 POs, 584 AIGs (12 redundant copies)
+   CirAigBuilder b(spec._seed, spec._redundancy);
+   switch (spec._kind) {
+      case GEN_MULTIPLIER: genMultiplier(b, spec._width); break;
+      case GEN_ADDER:      genAdder(b, spec._width); break;
+      case GEN_RANDOM:     genRandom(b, spec); break;
+   }
+   if (!b.load(*this)) {
+      cerr << "Error: the circuit is too large!!" << endl;
+      return false;
+   }
+
+   cout << "Generated: ";
+   switch (spec._kind) {
+      case GEN_MULTIPLIER:
+         cout << "multiplier " << spec._width << "x" << spec._width; break;
+      case GEN_ADDER:
+         cout << spec._width << "-bit adder"; break;
+      case GEN_RANDOM:
+         cout << "random DAG of depth " << std::max(std::min(spec._depth, spec._ands), 1u)
+              << (spec._fanout == GEN_FANOUT_POWER ? ", power law fanouts" : "");
+         break;
+   }
+   cout << "; " << _inputCount << " PIs, " << _outputCount << " POs, "
+        << _andGateCount << " AIGs (" << b.getCopyCount()
+        << " redundant copies)" << endl;
+   return true;
+}
@@ -0,0 +1,92 @@
+/****************************************************************************
+  FileName     [ cirGen.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the synthetic circuit generator ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_GEN_H
+#define CIR_GEN_H
+
+#include <vector>
+#include "cirDef.h"
+
+using namespace std;
+
+enum CirGenKind
+{
+   GEN_MULTIPLIER = 0,   // n x n array multiplier
+   GEN_ADDER      = 1,   // n-bit parallel prefix adder
+   GEN_RANDOM     = 2    // random DAG of a given size and depth
+};
+
+enum CirGenFanout
+{
+   GEN_FANOUT_UNIFORM = 0,   // any earlier node alike
+   GEN_FANOUT_POWER   = 1    // by popularity, for a heavy tailed fanout
+};
+
+struct CirGenSpec
+{
+   CirGenSpec(): _kind(GEN_RANDOM), _width(0), _ands(0), _inputs(64),
+                 _depth(32), _fanout(GEN_FANOUT_UNIFORM), _redundancy(0),
+                 _seed(1) {}
+   CirGenKind     _kind;
+   unsigned       _width;        // of the multiplier or the adder
+   unsigned       _ands;         // of the random DAG
+   unsigned       _inputs;       // of the random DAG
+   unsigned       _depth;        // of the random DAG
+   CirGenFanout   _fanout;       // of the random DAG
+   unsigned       _redundancy;   // % of the ANDs with a redundant copy
+   unsigned       _seed;
+};
+
+//------------------------------------------------------------------------
+//   Build an AIG by literals, to be loaded into a CirMgr
+//------------------------------------------------------------------------
+// Variables are numbered in the order they are made, the inputs first,
+// so the fanins of an AND always come before it. A planted copy of an
+// AND is (a & (b & c)) | (a & (b & !c)) for some other node c; the uses
+// of the AND then go to it and to its copy in turn, so that only fraig
+// can tell they are the same. Nothing is hashed here, so the structured
+// circuits keep their duplicates for strash as well.
+class CirAigBuilder
+{
+public:
+   CirAigBuilder(unsigned seed, unsigned redundancy);
+   ~CirAigBuilder() {}
+
+   unsigned newPI();
+   unsigned andOf(unsigned a, unsigned b);
+   unsigned orOf(unsigned a, unsigned b) { return andOf(a ^ 1, b ^ 1) ^ 1; }
+   unsigned xorOf(unsigned a, unsigned b);
+   void addPO(unsigned lit) { _pos.push_back(use(lit)); }
+
+   unsigned getVarCount() const { return _fanin0.size(); }
+   unsigned getFanoutCount(unsigned var) const { return _fanouts[var]; }
+   bool isAnd(unsigned var) const { return var > _inputs; }
+   unsigned getCopyCount() const { return _copies; }
+   unsigned random(unsigned range);
+
+   // the ANDs not reaching any PO are left out; false if out of IDs
+   bool load(CirMgr&) const;
+
+private:
+   unsigned                _inputs;
+   vector<unsigned>        _fanin0;     // by variable; literals
+   vector<unsigned>        _fanin1;
+   vector<unsigned>        _fanouts;    // by variable
+   vector<unsigned>        _copy;       // by variable; 0 if none
+   vector<char>            _turn;       // if the next use takes the copy
+   IdList                  _pos;
+   unsigned                _redundancy;
+   unsigned                _copies;
+   unsigned long long      _rand;
+
+   unsigned use(unsigned lit);
+   unsigned newAnd(unsigned a, unsigned b);
+   void plantCopy(unsigned var);
+};
+
+#endif // CIR_GEN_H
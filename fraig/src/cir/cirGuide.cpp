@@ -0,0 +1,351 @@
+/****************************************************************************
+  FileName     [ cirGuide.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define pattern generation for unresolved FEC groups ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include "cirMgr.h"
+#include "cirGate.h"
+#include "cirGuide.h"
+#include "util.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+static CirSimData randomWord() {
+   CirSimData ret(0), b = SIM_HIGHEST_BIT >> 15;
+   while (b) {
+      ret |= ((CirSimData)rnGen(1 << 16)) * b;
+      b >>= 16;
+   }
+   return ret;
+}
+
+// 1 with probability 2^-(level + 1), or 0 with it if `high`
+static CirSimData biasedWord(unsigned level, bool high) {
+   CirSimData w = randomWord();
+   for (unsigned i = 0; i < level; i++) w &= randomWord();
+   return high ? ~w : w;
+}
+
+// larger classes first
+struct CirFecSizeCompFN
+{
+   CirFecSizeCompFN(const CirFecStore& s): _store(s) {}
+   bool operator() (size_t a, size_t b) const {
+      const CirFecClass& ca = _store.getClass(a);
+      const CirFecClass& cb = _store.getClass(b);
+      return ca._size + ca._const > cb._size + cb._const;
+   }
+   const CirFecStore& _store;
+};
+
+/*************************************************/
+/*   Public member functions about Simulation    */
+/*************************************************/
+// Random simulation has converged; simulate the patterns made for the
+// pairs still in the same FEC groups until no pair can be split
+void
+CirMgr::guidedSim(const CirSimEffort& effort)
+{
+   // Output Example:
+   // Guided: R rounds, P patterns (B by biased values, S by SAT),
+   //         Q pairs proven, U too large for SAT; FEC groups X -> Y
+   if (!_fecGroupList) return;
+
+   size_t piSize = _piList.size();
+   vector<CirSimData> words(piSize), last(piSize);
+   for (size_t i = 0; i < piSize; i++)
+      last[i] = _piList[i]->getSimData();
+   size_t before = _fecStore->getClassCount();
+   unsigned rounds = 0, simulatedCount = 0;
+
+   double start = cpuTime();
+   CirSimStats* stats = effort._stats ? newSimStats() : 0;
+   CirSimProgress progress(_verbosity);
+   CirPatternGen gen(_piList, *_fecStore, &_profiler);
+
+   while (true) {
+      if (effort._patterns && simulatedCount >= effort._patterns) break;
+      if (effort._seconds && cpuTime() - start >= effort._seconds) break;
+
+      // the bits not taken by the patterns are random
+      for (size_t i = 0; i < piSize; i++)
+         words[i] = randomWord();
+      updateSimData();
+      unsigned found = gen.generate(words);
+      if (!found) {
+         // the cones were simulated with other values; the FEC groups
+         // are to be consistent with the values of the gates
+         for (size_t i = 0; i < piSize; i++)
+            _piList[i]->setSimData(last[i]);
+         simulateCircuit();
+         break;
+      }
+      last = words;
+
+      for (size_t i = 0; i < piSize; i++)
+         _piList[i]->setSimData(words[i]);
+      recordPatterns(&words[0], SIM_BITS);
+
+      double t0 = cpuTime();
+      simulateCircuit();
+      double t1 = cpuTime();
+      manipulateFECs();
+      double t2 = cpuTime();
+
+      size_t fecCnt = _fecStore->getClassCount();
+      if (stats)
+         stats->addRound(SIM_BITS, t1 - t0, t2 - t1, fecCnt, _fecStore->getMemberCount());
+      outputSimResult(&words[0]);
+      rounds++;
+      simulatedCount += SIM_BITS;
+
+      if (progress.show())
+         cout << "\rTotal #FEC Group: " << fecCnt
+              << " | Guided = " << simulatedCount << flush;
+   }
+
+   collectFECGroups();
+   if (progress.wasShown()) cout << endl;
+   cout << "Guided: " << rounds << " rounds, "
+        << gen.getBiasedCount() + gen.getSatCount() << " patterns ("
+        << gen.getBiasedCount() << " by biased values, "
+        << gen.getSatCount() << " by SAT), "
+        << gen.getProvenCount() << " pairs proven, "
+        << gen.getAbortedCount() << " too large for SAT; FEC groups "
+        << before << " -> " << _fecStore->getClassCount() << endl;
+   if (stats) {
+      if (rounds) stats->report(cpuTime() - start);
+      delete stats;
+   }
+}
+
+/*******************************************/
+/*   class CirPatternGen member functions  */
+/*******************************************/
+CirPatternGen::CirPatternGen(const GateList& piList, const CirFecStore& store,
+                             CirProfiler* prof):
+   _piList(piList), _store(store), _profiler(prof), _curStamp(0),
+   _biased(0), _sat(0), _proven(0), _aborted(0)
+{
+   for (size_t i = 0, n = _piList.size(); i < n; i++) {
+      unsigned id = _piList[i]->getID();
+      if (id >= _piIdx.size()) _piIdx.resize(id + 1, -1);
+      _piIdx[id] = i;
+   }
+   _solver.initialize();
+}
+
+unsigned
+CirPatternGen::generate(vector<CirSimData>& words)
+{
+   // the phases of the members, before the cones are simulated
+   for (size_t i = 0, n = _store.getClassCount(); i < n; i++) {
+      const CirFecClass& c = _store.getClass(i);
+      for (size_t j = 0; j < c._size; j++) {
+         CirGate* g = _store.getMember(c, j);
+         if (g->getID() >= _phase.size()) _phase.resize(g->getID() + 1);
+         _phase[g->getID()] = g->getSimData();
+      }
+   }
+
+   unsigned found = 0;
+   while (!found) {
+      selectPairs();
+      if (_pairs.empty()) return 0;
+
+      for (size_t i = 0, n = _pairs.size(); i < n && found < SIM_BITS; i++) {
+         const CirGuidePair& p = _pairs[i];
+         CirSimData slot = SIM_HIGHEST_BIT >> found;
+         collectCone(p);
+         if (tryBiased(p, slot, words)) {
+            _biased++;
+            found++;
+            continue;
+         }
+         if (_coneAigs.size() > GUIDE_SAT_CONE) {
+            _aborted++;
+            settle(p);
+            continue;
+         }
+         if (trySat(p, slot, words)) {
+            _sat++;
+            found++;
+         }
+         else {
+            _proven++;
+            settle(p);
+         }
+      }
+   }
+   return found;
+}
+
+/********************************************/
+/*   Private member functions about guides  */
+/********************************************/
+// up to GUIDE_CLASS_PAIRS pairs from each class, spread over its members
+void
+CirPatternGen::selectPairs()
+{
+   _pairs.clear();
+   vector<size_t> order(_store.getClassCount());
+   for (size_t i = 0, n = order.size(); i < n; i++) order[i] = i;
+   stable_sort(order.begin(), order.end(), CirFecSizeCompFN(_store));
+
+   for (size_t i = 0, n = order.size(); i < n && _pairs.size() < SIM_BITS; i++) {
+      const CirFecClass& c = _store.getClass(order[i]);
+      CirGate* rep = (c._const ? 0 : _store.getMember(c, 0));
+      size_t first = (c._const ? 0 : 1);
+      if (c._size <= first) continue;
+
+      size_t others = c._size - first;
+      size_t parts = std::min((size_t)GUIDE_CLASS_PAIRS, others);
+      for (size_t t = 0; t < parts; t++) {
+         size_t b = first + t * others / parts, e = first + (t + 1) * others / parts;
+         for (size_t j = b; j < e; j++) {
+            CirGate* g = _store.getMember(c, j);
+            if (isSettled(rep, g)) continue;
+            CirSimData r = (rep ? _phase[rep->getID()] : 0);
+            CirGuidePair p = { rep, g, _phase[g->getID()] != r };
+            _pairs.push_back(p);
+            break;
+         }
+      }
+   }
+}
+
+bool
+CirPatternGen::isSettled(CirGate* rep, CirGate* g) const
+{
+   return _settled.count(make_pair(rep ? rep->getID() : 0, g->getID()));
+}
+
+void
+CirPatternGen::settle(const CirGuidePair& p)
+{
+   _settled.insert(make_pair(p._rep ? p._rep->getID() : 0, p._gate->getID()));
+}
+
+// the transitive fanins of the pair, fanins first
+void
+CirPatternGen::collectCone(const CirGuidePair& p)
+{
+   _cone.clear();
+   _conePIs.clear();
+   _coneAigs.clear();
+   if (++_curStamp == 0) {
+      _stamp.assign(_stamp.size(), 0);
+      _curStamp = 1;
+   }
+
+   // (gate, #fanins visited)
+   vector<pair<CirGate*, size_t> > stack;
+   CirGate* roots[2] = { p._gate, p._rep };
+   for (size_t r = 0; r < 2; r++) {
+      if (!roots[r]) continue;
+      stack.push_back(make_pair(roots[r], 0));
+      while (!stack.empty()) {
+         CirGate* g = stack.back().first;
+         if (g->getID() >= _stamp.size()) _stamp.resize(g->getID() + 1, 0);
+         if (stack.back().second == 0 && _stamp[g->getID()] == _curStamp) {
+            stack.pop_back();
+            continue;
+         }
+         _stamp[g->getID()] = _curStamp;
+         if (g->isAig() && stack.back().second < 2) {
+            stack.push_back(make_pair(g->getFanin(stack.back().second++), 0));
+            continue;
+         }
+         stack.pop_back();
+         _cone.push_back(g);
+         if (g->isAig()) _coneAigs.push_back(g);
+         else if (g->_type == PI_GATE) _conePIs.push_back(g);
+      }
+   }
+}
+
+// simulate the cone with biased inputs; on a difference, copy the
+// input values of that bit to `slot`
+bool
+CirPatternGen::tryBiased(const CirGuidePair& p, CirSimData slot, vector<CirSimData>& words)
+{
+   for (unsigned t = 0; t < GUIDE_BIASED_TRIES; t++) {
+      for (size_t i = 0, n = _conePIs.size(); i < n; i++)
+         _conePIs[i]->setSimData(biasedWord(1 + t / 2, rnGen(2)));
+      for (size_t i = 0, n = _coneAigs.size(); i < n; i++)
+         _coneAigs[i]->simulate();
+
+      CirSimData r = (p._rep ? p._rep->getSimData() : 0);
+      CirSimData diff = p._gate->getSimData(p._inv) ^ r;
+      if (!diff) continue;
+
+      CirSimData bit = diff & (~diff + 1);
+      for (size_t i = 0, n = _conePIs.size(); i < n; i++) {
+         CirSimData& w = words[_piIdx[_conePIs[i]->getID()]];
+         if (_conePIs[i]->getSimData() & bit) w |= slot;
+         else w &= ~slot;
+      }
+      return true;
+   }
+   return false;
+}
+
+// the pattern in `slot` if the pair can differ; false if proven
+bool
+CirPatternGen::trySat(const CirGuidePair& p, CirSimData slot, vector<CirSimData>& words)
+{
+   if (_profiler) _profiler->start(PHASE_CNF);
+   for (size_t i = 0, n = _cone.size(); i < n; i++)
+      getVar(_cone[i]);
+   if (_profiler) _profiler->stop();
+
+   _solver.assumeRelease();
+   if (p._rep) {
+      Var out = _solver.newVar();
+      _solver.addXorCNF(out, getVar(p._gate), false, getVar(p._rep), p._inv);
+      _solver.assumeProperty(out, true);
+   }
+   else _solver.assumeProperty(getVar(p._gate), !p._inv);
+   if (_profiler) _profiler->start(PHASE_SAT);
+   bool sat = _solver.assumpSolve();
+   if (_profiler) _profiler->stop();
+   if (!sat) return false;
+
+   for (size_t i = 0, n = _conePIs.size(); i < n; i++) {
+      CirSimData& w = words[_piIdx[_conePIs[i]->getID()]];
+      if (_solver.getValue(getVar(_conePIs[i])) == 1) w |= slot;
+      else w &= ~slot;
+   }
+   return true;
+}
+
+// encode a gate whose fanins are already encoded; the constant and the
+// undefined gates are 0 as in simulation
+Var
+CirPatternGen::getVar(CirGate* g)
+{
+   unsigned id = g->getID();
+   if (id >= _vars.size()) _vars.resize(id + 1, 0);
+   if (_vars[id]) return _vars[id];
+
+   Var v = _vars[id] = _solver.newVar();
+   if (g->isAig())
+      _solver.addAigCNF(v, getVar(g->getFanin(0)), g->getInv(0),
+                           getVar(g->getFanin(1)), g->getInv(1));
+   else if (g->_type != PI_GATE)
+      _solver.assertProperty(v, false);
+   return v;
+}
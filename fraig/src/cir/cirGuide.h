@@ -0,0 +1,92 @@
+/****************************************************************************
+  FileName     [ cirGuide.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define pattern generation for unresolved FEC groups ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_GUIDE_H
+#define CIR_GUIDE_H
+
+#include <vector>
+#include <set>
+#include "cirDef.h"
+#include "cirGate.h"
+#include "cirSim.h"
+#include "cirProfile.h"
+
+using namespace std;
+
+const unsigned GUIDE_CLASS_PAIRS = 4;      // pairs taken from a class per round
+const unsigned GUIDE_BIASED_TRIES = 4;     // biased words simulated per pair
+const unsigned GUIDE_SAT_CONE    = 2000;   // max. #AIGs in a cone given to SAT
+
+// a member and the representative of its FEC group (0: the constant)
+struct CirGuidePair
+{
+   CirGate*  _rep;
+   CirGate*  _gate;
+   bool      _inv;     // if they are complemented
+};
+
+//------------------------------------------------------------------------
+//   Distinguishing patterns for the largest FEC groups
+//------------------------------------------------------------------------
+// Each round takes a few pairs from every group, largest groups first.
+// A pair is first simulated over its cone with words biased towards 0 or
+// 1 on each input; failing that, the cone is handed to a SAT solver that
+// is built up cone by cone. The input values found go to one bit of the
+// words for the next bit-parallel simulation, so a round yields up to
+// SIM_BITS patterns. Pairs proven equivalent, or with a cone too large
+// for SAT, are not tried again.
+class CirPatternGen
+{
+public:
+   CirPatternGen(const GateList& piList, const CirFecStore& store,
+                 CirProfiler* prof = 0);
+   ~CirPatternGen() {}
+
+   // put the patterns into the highest bits of the words, one per PI,
+   // and return how many there are; 0 if there are no pairs left
+   unsigned generate(vector<CirSimData>& words);
+
+   unsigned getBiasedCount() const { return _biased; }
+   unsigned getSatCount() const { return _sat; }
+   unsigned getProvenCount() const { return _proven; }
+   unsigned getAbortedCount() const { return _aborted; }
+
+private:
+   const GateList&                  _piList;
+   const CirFecStore&               _store;
+   CirProfiler*                     _profiler; // for the CNF and SAT calls
+   vector<int>                      _piIdx;    // by gate ID; -1 if not a PI
+   vector<CirGuidePair>             _pairs;
+   vector<CirSimData>               _phase;    // by gate ID, from generate()
+   set<pair<unsigned, unsigned> >   _settled;  // (rep, member) IDs
+
+   // the cone of the current pair, in topological order
+   GateList                         _cone;
+   GateList                         _conePIs;
+   GateList                         _coneAigs; // to be simulated
+   vector<unsigned>                 _stamp;    // by gate ID
+   unsigned                         _curStamp;
+
+   SatSolver                        _solver;
+   vector<Var>                      _vars;     // by gate ID; 0 if not encoded
+
+   unsigned                         _biased;
+   unsigned                         _sat;
+   unsigned                         _proven;
+   unsigned                         _aborted;
+
+   void selectPairs();
+   bool isSettled(CirGate*, CirGate*) const;
+   void settle(const CirGuidePair&);
+   void collectCone(const CirGuidePair&);
+   bool tryBiased(const CirGuidePair&, CirSimData slot, vector<CirSimData>&);
+   bool trySat(const CirGuidePair&, CirSimData slot, vector<CirSimData>&);
+   Var getVar(CirGate*);
+};
+
+#endif // CIR_GUIDE_H
@@ -60,6 +60,7 @@ static char buf[BUFFER_SIZE];
 static string errMsg;
 static int errInt;
 static CirGate *errGate;
+static unsigned errLine;   // for the AIGs not yet created (errGate = 0)
 
 static bool
 parseError(CirParseError err)
@@ -124,8 +125,8 @@ parseError(CirParseError err)
       case REDEF_GATE:
          cerr << "[ERROR] Line " << lineNo+1 << ": Literal \"" << errInt
               << "\" is redefined, previously defined as "
-              << errGate->getTypeStr() << " in line " << errGate->getLineNo()
-              << "!!" << endl;
+              << (errGate ? errGate->getTypeStr() : "AIG") << " in line "
+              << (errGate ? errGate->getLineNo() : errLine) << "!!" << endl;
          break;
       case REDEF_SYMBOLIC_NAME:
          cerr << "[ERROR] Line " << lineNo+1 << ": Symbolic name for \""
@@ -348,6 +349,10 @@ static void checkLiteralID(CirMgr* mgr, unsigned gid, bool checkEven, bool check
       } else if (errGate != 0 && errGate->_type != UNDEF_GATE) {
          errInt = gid;
          throw REDEF_GATE;
+      } else if (mgr->isAigDefined(gid / 2)) {
+         errInt = gid;
+         errGate = 0; errLine = mgr->getAigDefLine(gid / 2);
+         throw REDEF_GATE;
       }
    }
    if (checkEven && gid % 2 != 0) {
@@ -364,11 +369,50 @@ GateList& CirMgr::getDfsList() const {
       _dfsList.clear();
       dfs(&_dfsList);
       _dfsList_clean = true;
+      _aig_clean = false;
    }
    return _dfsList;
 }
 
+// the PIs, then the UNDEF gates (as free inputs), then the AIGs in
+// DFS order; the POs are the outputs, in order
+const CirAig& CirMgr::getAig() const {
+   GateList& l = getDfsList();
+   if (_aig_clean) return _aig;
+   CirPhaseScope prof(_profiler, PHASE_DFS);
+
+   _aig.clear();
+   _aig.reserve(l.size());
+   _simValues.clear();
+   _aigGates.assign(1, getGate(0));
+   _aigLits.assign(_gates.rbegin()->first + 1, 0);
+   for (size_t i = 0, n = _piList.size(); i < n; i++) {
+      _aigLits[_piList[i]->getID()] = _aig.addInput();
+      _aigGates.push_back(_piList[i]);
+   }
+   for (size_t i = 0, n = l.size(); i < n; i++) {
+      if (l[i]->_type != UNDEF_GATE) continue;
+      _aigLits[l[i]->getID()] = _aig.addInput();
+      _aigGates.push_back(l[i]);
+   }
+   for (size_t i = 0, n = l.size(); i < n; i++) {
+      CirGate* g = l[i];
+      if (!g->isAig()) continue;
+      _aigLits[g->getID()] =
+         _aig.addAnd(_aigLits[g->getFanin(0)->getID()] ^ g->getInv(0),
+                     _aigLits[g->getFanin(1)->getID()] ^ g->getInv(1));
+      _aigGates.push_back(g);
+   }
+   for (size_t i = 0, n = _poList.size(); i < n; i++) {
+      CirGate* po = _poList[i];
+      _aig.addOutput(_aigLits[po->getFanin(0)->getID()] ^ po->getInv(0));
+   }
+   _aig_clean = true;
+   return _aig;
+}
+
 void CirMgr::dfs(GateList* l) const {
+   CirPhaseScope prof(_profiler, PHASE_DFS);
    // do dfs and leave the mark for tracing
    GateList::const_iterator it = _poList.begin();
    CirGate::clearMark();
@@ -393,8 +437,17 @@ CirGate* CirMgr::addPO(int lineno, unsigned lid) {
    return (_gates[gid] = po);
 }
 
+// when reading with strash, only the definition is kept here
+// and the gate is created (or not) by initialize()
 CirGate* CirMgr::addAIG(int lineno, unsigned lid, unsigned fin1, unsigned fin2) {
    unsigned gid = lid / 2;
+   if (_strashOnRead) {
+      if (_aigDefs.empty()) _aigDefs.resize(_maxNum + 1);
+      _aigDefs[gid]._lineNo = lineno;
+      _aigDefs[gid]._fanin[0] = fin1;
+      _aigDefs[gid]._fanin[1] = fin2;
+      return 0;
+   }
    AigGate* aig = new AigGate(gid, lineno);
    aig->_fanin[0] = fin1;
    aig->_fanin[1] = fin2;
@@ -408,6 +461,12 @@ CirGate* CirMgr::addUndef(unsigned gid) {
 }
 
 void CirMgr::initialize() {
+   CirPhaseScope prof(_profiler, PHASE_INIT);
+   if (_strashOnRead) {
+      initializeStrashed();
+      return;
+   }
+
    CirGateV pi;
    bool inv;
    CirGate* self;
@@ -432,9 +491,129 @@ void CirMgr::initialize() {
    }
 }
 
+// build the AIGs in topological order; each one is simplified by the
+// rules of optimize() or found in the strash hash, else it is created
+void CirMgr::initializeStrashed() {
+   size_t nVars = _maxNum + 1;
+   _aigDefs.resize(nVars);
+
+   // topological order of the definitions;
+   // on a combinational loop, fall back to creating every AIG as it is
+   IdList order;
+   order.reserve(_andGateCount);
+   vector<char> state(nVars, 0);   // 0 = new, 1 = on the DFS path, 2 = done
+   IdList stack;
+   bool loop = false;
+   for (unsigned v = 1; v < nVars && !loop; v++) {
+      if (!_aigDefs[v]._lineNo || state[v]) continue;
+      stack.push_back(v);
+      while (!stack.empty() && !loop) {
+         unsigned u = stack.back();
+         if (state[u] == 2) { stack.pop_back(); continue; }
+         if (state[u] == 1) {
+            state[u] = 2;
+            order.push_back(u);
+            stack.pop_back();
+            continue;
+         }
+         state[u] = 1;
+         for (size_t i = 0; i < 2; i++) {
+            unsigned f = _aigDefs[u]._fanin[i] / 2;
+            if (!_aigDefs[f]._lineNo) continue;
+            if (state[f] == 1) loop = true;
+            else if (state[f] == 0) stack.push_back(f);
+         }
+      }
+   }
+
+   _strashOnRead = false;
+   if (loop) {
+      cerr << "Warning: combinational loop found; circuit is read without strash!!" << endl;
+      for (unsigned v = 1; v < nVars; v++) {
+         if (_aigDefs[v]._lineNo)
+            addAIG(_aigDefs[v]._lineNo, v * 2, _aigDefs[v]._fanin[0], _aigDefs[v]._fanin[1]);
+      }
+      vector<CirAigDef>().swap(_aigDefs);
+      initialize();
+      return;
+   }
+
+   // resolved gate (with phase) of each variable
+   vector<CirGateV> lits(nVars, 0);
+   lits[0] = (CirGateV)_gates[0];
+   for (size_t i = 0, n = _piList.size(); i < n; i++)
+      lits[_piList[i]->getID()] = (CirGateV)_piList[i];
+
+   HashMap<CirStrashKey, CirGate*> hashStrash(getHashSize(_andGateCount * 5 / 3));
+   unsigned strashed = 0, simplified = 0;
+   _andGateCount = 0;
+
+   for (size_t k = 0, n = order.size(); k < n; k++) {
+      unsigned v = order[k];
+      CirGateV fa = getStrashedFanin(lits, _aigDefs[v]._fanin[0]);
+      CirGateV fb = getStrashedFanin(lits, _aigDefs[v]._fanin[1]);
+      CirGate* ga = (CirGate*)(fa & ~(CirGateV)1);
+      CirGate* gb = (CirGate*)(fb & ~(CirGateV)1);
+      bool ia = fa & 1, ib = fb & 1;
+
+      // same rules as optimize()
+      if (gb->_type == CONST_GATE) {
+         swap(ga, gb);
+         swap(ia, ib);
+      }
+      if ((ga->_type == CONST_GATE && !ia) || (ga == gb && ia != ib)) {
+         lits[v] = (CirGateV)_gates[0];
+         simplified++;
+         continue;
+      }
+      if ((ga->_type == CONST_GATE && ia) || (ga == gb && ia == ib)) {
+         lits[v] = (CirGateV)gb | ib;
+         simplified++;
+         continue;
+      }
+
+      CirStrashKey key(ga, ia, gb, ib);
+      CirGate* t = 0;
+      if (hashStrash.check(key, t)) {
+         lits[v] = (CirGateV)t;
+         strashed++;
+         continue;
+      }
+
+      CirGate* aig = new AigGate(v, _aigDefs[v]._lineNo);
+      aig->addFanin((CirGateV)ga | ia);
+      aig->addFanin((CirGateV)gb | ib);
+      ga->addFanout((CirGateV)aig | ia);
+      gb->addFanout((CirGateV)aig | ib);
+      _gates[v] = aig;
+      _andGateCount++;
+      hashStrash.forceInsert(key, aig);
+      lits[v] = (CirGateV)aig;
+   }
+   vector<CirAigDef>().swap(_aigDefs);
+
+   for (size_t i = 0, n = _poList.size(); i < n; i++) {
+      CirGate* po = _poList[i];
+      CirGateV f = getStrashedFanin(lits, po->_fanin[0]);
+      po->setFanin(0, f);
+      ((CirGate*)(f & ~(CirGateV)1))->addFanout((CirGateV)po | (f & 1));
+   }
+
+   cout << "Strashing: " << strashed << " AIGs merged and " << simplified
+        << " simplified on reading" << endl;
+}
+
+// gate (with phase) of the literal; undefined ones are created here
+CirGateV CirMgr::getStrashedFanin(vector<CirGateV>& lits, unsigned lid) {
+   unsigned gid = lid / 2;
+   if (!lits[gid]) lits[gid] = (CirGateV)addUndef(gid);
+   return lits[gid] ^ (lid & 1);
+}
+
 bool
-CirMgr::readCircuit(const string& fileName)
+CirMgr::readCircuit(const string& fileName, bool strash)
 {
+   CirPhaseScope prof(_profiler, PHASE_PARSE);
    ifstream f(fileName.c_str());
    if (!f.is_open()) {
       f.close();
@@ -443,6 +622,7 @@ CirMgr::readCircuit(const string& fileName)
    }
 
    bool ok = true;
+   _strashOnRead = strash;
 
    try {
       lineNo = 0;
@@ -643,6 +823,11 @@ CirMgr::printSummary() const
    cout << "  AIG   " << setw(8) << right << _andGateCount << endl;
    cout << "------------------" << endl;
    cout << "  Total " << setw(8) << right << sum << endl;
+   if (_balanced) {
+      cout << "------------------" << endl;
+      cout << "  Depth " << setw(8) << right << _depthAfter
+           << " (" << _depthBefore << " before balancing)" << endl;
+   }
 }
 
 void
@@ -745,6 +930,51 @@ CirMgr::printFECPairs() const
    }
 }
 
+/*********************
+Memory of the circuit
+  Gate view   :     1234 gates,   0.26 MB (223.1 bytes per gate)
+  AIG core    :     1200 nodes,   0.01 MB (8.0 bytes per node)
+  Side tables :   0.01 MB (gates by node, literals by gate ID)
+  Total       :   0.28 MB
+*********************/
+// the gate view is estimated by the sizes of the gates, their fanout
+// lists and names, and the nodes of the map. The core and its side tables
+// are a read-only view kept next to the gates, so they add to it
+void
+CirMgr::printMemory() const
+{
+   const CirAig& aig = getAig();
+   const size_t mapNode = 4 * sizeof(void*) + sizeof(GateMap::value_type);
+   size_t gateBytes = 0;
+   for (GateMap::const_iterator it = _gates.begin(); it != _gates.end(); ++it) {
+      const CirGate* g = it->second;
+      gateBytes += sizeof(AigGate) + mapNode
+                 + g->_fanoutList.capacity() * sizeof(CirGateV)
+                 + (g->_name.empty() ? 0 : g->_name.capacity() + 1);
+   }
+   size_t coreBytes = aig.getMemSize();
+   size_t sideBytes = _aigGates.capacity() * sizeof(CirGate*)
+                    + _aigLits.capacity() * sizeof(unsigned);
+
+   double mb = 1 << 20;
+   ios::fmtflags flags = cout.flags();
+   cout << fixed << "Memory of the circuit" << endl
+        << "  Gate view   : " << setw(8) << _gates.size() << " gates, "
+        << setprecision(2) << setw(6) << gateBytes / mb << " MB ("
+        << setprecision(1) << (double)gateBytes / std::max(_gates.size(), (size_t)1)
+        << " bytes per gate)" << endl
+        << "  AIG core    : " << setw(8) << aig.getNodeCount() << " nodes, "
+        << setprecision(2) << setw(6) << coreBytes / mb << " MB ("
+        << setprecision(1) << (double)coreBytes / aig.getNodeCount()
+        << " bytes per node)" << endl
+        << "  Side tables : " << setprecision(2) << setw(6) << sideBytes / mb
+        << " MB (gates by node, literals by gate ID)" << endl
+        << "  Total       : " << setprecision(2) << setw(6)
+        << (gateBytes + coreBytes + sideBytes) / mb << " MB" << endl;
+   cout.flags(flags);
+   cout << setprecision(6);
+}
+
 void
 CirMgr::writeAag(ostream& outfile) const
 {
@@ -797,6 +1027,61 @@ CirMgr::writeAag(ostream& outfile) const
    outfile << "c\n" << "generated by cirWrite command" << endl;
 }
 
+// binary AIGER: the PIs become variables 1..I and the AIGs in the DFS
+// list the next ones; undefined gates are written as the constant 0
+void
+CirMgr::writeAig(ostream& outfile) const
+{
+   GateList& l = getDfsList();
+   unsigned nIn = _piList.size(), newA = 0;
+   IdList newId(_maxNum + 1, 0);
+   for (size_t i = 0; i < nIn; i++)
+      newId[_piList[i]->getID()] = i + 1;
+   for (size_t i = 0, n = l.size(); i < n; i++)
+      if (l[i]->isAig()) newId[l[i]->getID()] = nIn + ++newA;
+
+   // header: aig M I L O A, M = I + A
+   outfile << "aig "
+           << nIn + newA << " "
+           << nIn << " "
+           << _latchCount << " "
+           << _outputCount << " "
+           << newA << endl;
+
+   // output
+   for (size_t i = 0, n = _poList.size(); i < n; i++)
+      outfile << (newId[_poList[i]->getFanin(0)->getID()] * 2 + (_poList[i]->getInv(0) ? 1 : 0)) << endl;
+
+   // aig: the deltas lhs - rhs0 and rhs0 - rhs1 (rhs0 >= rhs1), by 7 bits
+   for (size_t i = 0, n = l.size(); i < n; i++) {
+      if (!l[i]->isAig()) continue;
+      unsigned lhs = newId[l[i]->getID()] * 2;
+      unsigned r0 = newId[l[i]->getFanin(0)->getID()] * 2 + (l[i]->getInv(0) ? 1 : 0);
+      unsigned r1 = newId[l[i]->getFanin(1)->getID()] * 2 + (l[i]->getInv(1) ? 1 : 0);
+      if (r0 < r1) swap(r0, r1);
+      unsigned delta[2] = { lhs - r0, r0 - r1 };
+      for (size_t k = 0; k < 2; k++) {
+         unsigned x = delta[k];
+         while (x & ~0x7F) {
+            outfile.put((char)((x & 0x7F) | 0x80));
+            x >>= 7;
+         }
+         outfile.put((char)x);
+      }
+   }
+
+   // symbol
+   for (size_t i = 0; i < nIn; i++)
+      if (!_piList[i]->_name.empty())
+         outfile << 'i' << i << " " << _piList[i]->_name << endl;
+   for (size_t i = 0, n = _poList.size(); i < n; i++)
+      if (!_poList[i]->_name.empty())
+         outfile << 'o' << i << " " << _poList[i]->_name << endl;
+
+   // comment
+   outfile << "c\n" << "generated by cirWrite command" << endl;
+}
+
 void
 CirMgr::writeGate(ostream& outfile, CirGate *g) const
 {
@@ -20,20 +20,34 @@ using namespace std;
 
 #include "cirDef.h"
 #include "cirGate.h"
+#include "cirSim.h"
+#include "cirPattern.h"
+#include "cirProfile.h"
+#include "cirAig.h"
+#include "rnGen.h"
 
 extern CirMgr *cirMgr;
 
 class CirMgr
 {
+   friend class CirRewriter;
+   friend class CirBalancer;
+   friend class CirAigBuilder;
+   friend class CirOdcSweeper;
+
 public:
-   CirMgr(): _dfsList_clean(false), _fecGroupList(0), _satSolver(0) {}
+   CirMgr(): _verbosity(CIR_VERB_ITEM), _simLog(0), _dfsList_clean(false), _aig_clean(false), _strashOnRead(false),
+           _balanced(false), _depthBefore(0), _depthAfter(0), _fecGroupList(0), _fecStore(0), _satSolver(0), _rnGen(0) {}
    ~CirMgr() {
       for (GateMap::const_iterator it = _gates.begin(); it != _gates.end(); ++it) {
          delete it->second;
       }
 
+      if (_simLog)       delete _simLog;
       if (_fecGroupList) delete _fecGroupList;
+      if (_fecStore)     delete _fecStore;
       if (_satSolver)    delete _satSolver;
+      if (_rnGen)        delete _rnGen;
    }
 
    // Access functions
@@ -56,22 +70,68 @@ public:
    GateList& getDfsList() const;
    void dfs(GateList* l = 0) const;
 
+   // a read-only compact core of the DFS list, kept next to the gates,
+   // which are its side table
+   const CirAig& getAig() const;
+   CirGate* getAigGate(unsigned node) const { return _aigGates[node]; }
+   // literal in the core by gate ID; 0 if not in the DFS list
+   unsigned getAigLit(unsigned gid) const {
+      return gid < _aigLits.size() ? _aigLits[gid] : 0;
+   }
+
    // Member functions about circuit construction
-   bool readCircuit(const string&);
+   bool readCircuit(const string&, bool strash = false);
+   bool generate(const CirGenSpec&);
 
    // Member functions about circuit optimization
-   void sweep();
+   void sweep(bool quiet = false);
    void optimize();
+   void rewrite();
+   void balance();
+   void odcSweep(unsigned levels = ODC_WINDOW);
+
+   // Member functions about cuts
+   void enumerateCuts(unsigned k = CUT_SIZE, unsigned limit = CUT_PRIORITY,
+                      bool stats = false);
 
    // Member functions about simulation
-   void randomSim();
-   void fileSim(ifstream&);
-   void setSimLog(ofstream *logFile) { _simLog = logFile; }
+   void randomSim(const CirSimEffort& effort = CirSimEffort());
+   void fileSim(CirPatternReader&, bool stats = false);
+   void guidedSim(const CirSimEffort& effort = CirSimEffort());
+   bool saveSignatures(const string&) const;
+   bool loadSignatures(const string&);
+   // random patterns of its own; the global rnGen otherwise
+   void setRandomSeed(unsigned seed) {
+      delete _rnGen;
+      _rnGen = new LocalRandomNumGen(seed);
+   }
+   void setSimLog(ofstream *logFile, bool binary = false) {
+      delete _simLog;
+      _simLog = (logFile ? new CirSimLog(*logFile, _piList.size(), _poList.size(), binary) : 0);
+   }
 
    // Member functions about fraig
    void strash();
    void printFEC() const;
-   void fraig();
+   void fraig(bool preprocess = false, FraigOrder order = FRAIG_ORDER_GROUP,
+              unsigned cutSize = FRAIG_CUT_SIZE, const string& dratName = "");
+
+   // Member functions about output cones
+   CirMgr* extractCone(const IdList& pos) const;
+   void fraigParallel(unsigned threads, bool preprocess = false,
+                      FraigOrder order = FRAIG_ORDER_GROUP,
+                      unsigned cutSize = FRAIG_CUT_SIZE);
+
+   // Member functions about equivalence checking
+   bool buildMiter(const CirMgr&, const CirMgr&, bool byName = false);
+   unsigned checkMiter();
+
+   // Member functions about messages
+   void setVerbosity(CirVerbosity v) { _verbosity = v; }
+   CirVerbosity getVerbosity() const { return _verbosity; }
+
+   // Member functions about profiling
+   CirProfiler& getProfiler() const { return _profiler; }
 
    // Member functions about circuit reporting
    void printSummary() const;
@@ -80,7 +140,9 @@ public:
    void printPOs() const;
    void printFloatGates() const;
    void printFECPairs() const;
+   void printMemory() const;
    void writeAag(ostream&) const;
+   void writeAig(ostream&) const;
    void writeGate(ostream&, CirGate*) const;
 
    CirGate* addPI(int, unsigned);
@@ -90,6 +152,12 @@ public:
 
    void initialize();
 
+   // AIGs defined so far when reading with strash
+   bool isAigDefined(unsigned gid) const {
+      return gid < _aigDefs.size() && _aigDefs[gid]._lineNo;
+   }
+   unsigned getAigDefLine(unsigned gid) const { return _aigDefs[gid]._lineNo; }
+
    unsigned int _maxNum;
    unsigned int _inputCount;
    unsigned int _latchCount;
@@ -97,7 +165,8 @@ public:
    unsigned int _andGateCount;
 
 private:
-   ofstream           *_simLog;
+   CirVerbosity       _verbosity;
+   CirSimLog          *_simLog;
    GateList           _piList;
    GateList           _poList;
    // GateList           _totalList;
@@ -107,18 +176,63 @@ private:
    // mutable GateList   _unusedList;
    mutable bool       _dfsList_clean;
 
+   // the core and its side tables, made again with the DFS list
+   mutable CirAig     _aig;
+   mutable GateList   _aigGates;      // by node
+   mutable IdList     _aigLits;       // by gate ID
+   mutable bool       _aig_clean;
+
+   bool               _strashOnRead;
+   vector<CirAigDef>  _aigDefs;
+
+   // depth before the first balancing and after the last one, for
+   // printSummary()
+   bool               _balanced;
+   unsigned           _depthBefore;
+   unsigned           _depthAfter;
+
+   // PI words of every block simulated, and #patterns in each
+   vector<CirSimData> _simPatterns;
+   IdList             _simCounts;
+   mutable vector<CirSimData> _simValues;   // by node of the core
+
    FECGroupList*      _fecGroupList;
+   CirFecStore*       _fecStore;       // refined by simulation
    SatSolver*         _satSolver;
+   LocalRandomNumGen* _rnGen;          // 0: the global rnGen
+
+   mutable CirProfiler _profiler;     // time and memory by phase
+
+   // for circuit construction
+   void initializeStrashed();
+   CirGateV getStrashedFanin(vector<CirGateV>&, unsigned);
+
+   // for optimization
+   unsigned getDepth() const;
+   bool isVerbose() const { return _verbosity >= CIR_VERB_ITEM; }
+   bool isSilent() const { return _verbosity < CIR_VERB_SUMMARY; }
 
    // for simulation
    void simulateCircuit();
+   void updateSimData();
    void initFECGroup();
    void manipulateFECs();
+   void collectFECGroups();
+   CirSimStats* newSimStats() const;
    void outputSimResult(CirSimData[], unsigned = 0);
+   void recordPatterns(const CirSimData*, unsigned);
+   unsigned long long getNetlistHash() const;
 
    // for fraig
    void genProofModel(SatSolver&);
-   void mergeGate(CirGate*, CirGate*);
+   void preprocessProofModel(SatSolver&);
+   void fraigGroup(SatSolver&, CirCutProver&, CirFraigStats&);
+   void fraigTopo(SatSolver&, CirCutProver&, CirFraigStats&);
+   void refineFECGroups(SatSolver&);
+   void mergeGate(CirGate*, CirGate*, bool inv = false);
+
+   // for equivalence checking
+   void addMiterCone(const CirMgr&, IdList&);
 
    #ifdef CHECK_INTEGRITY
    bool checkIntegrity(bool verbose = false) const;
@@ -0,0 +1,388 @@
+/****************************************************************************
+  FileName     [ cirOdc.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define redundancy removal by observability don't cares ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include "cirMgr.h"
+#include "cirGate.h"
+#include "cirOdc.h"
+#include "util.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+static CirSimData odcRandomData() {
+   // rnGen can only produce 31 bits random number
+   CirSimData ret(0), b = SIM_HIGHEST_BIT >> 15;
+   while (b) {
+      ret |= ((CirSimData)rnGen(1 << 16)) * b;
+      b >>= 16;
+   }
+   return ret;
+}
+
+/*****************************************/
+/*   Public member functions of CirMgr   */
+/*****************************************/
+// Replace the AIGs whose changes no PO can observe by constants or by
+// nodes below them; see CirOdcSweeper
+void
+CirMgr::odcSweep(unsigned levels)
+{
+   // Output Example:
+   //   ODC: !0 merging 12
+   //   ODC: 7 merging !25
+   // ODC: 12 AIGs replaced (5 by constants), 30 removed with them; 46 SAT checks, 4 refuted
+   CirPhaseScope prof(_profiler, PHASE_OPT);
+   CirOdcSweeper odc(this, levels);
+   odc.sweep();
+   _dfsList_clean = false;
+   // the fanouts of a replaced node no longer compute what the proof
+   // model says they do
+   delete _satSolver;
+   _satSolver = 0;
+
+   if (!isSilent())
+      cout << "ODC: " << odc.getConstCount() + odc.getNodeCount()
+           << " AIGs replaced (" << odc.getConstCount() << " by constants), "
+           << odc.getRemovedCount() << " removed with them; "
+           << odc.getSatCount() << " SAT checks, " << odc.getRefutedCount()
+           << " refuted" << endl;
+
+   #ifdef CHECK_INTEGRITY
+   checkIntegrity();
+   #endif  // CHECK_INTEGRITY
+}
+
+/*******************************************/
+/*   class CirOdcSweeper member functions  */
+/*******************************************/
+CirOdcSweeper::CirOdcSweeper(CirMgr* mgr, unsigned levels):
+   _mgr(mgr), _levels(std::max(levels, 1u)), _support(0), _byConst(0),
+   _byNode(0), _removed(0), _satCalls(0), _refuted(0)
+{
+   // the gates stay the side table of this core until sweep() is done
+   const CirAig& aig = _mgr->getAig();
+   _inputs = aig.getInputCount();
+   _nodes = aig.getNodeCount();
+
+   _fanins.assign(2 * _nodes, 0);
+   _fanouts.resize(_nodes);
+   _levelOf.resize(_nodes);
+   for (unsigned n = 0; n < _nodes; n++) {
+      _levelOf[n] = aig.getLevel(n);
+      if (!isAnd(n)) continue;
+      for (unsigned j = 0; j < 2; j++) {
+         _fanins[2 * n + j] = (j ? aig.getFanin1(n) : aig.getFanin0(n));
+         _fanouts[_fanins[2 * n + j] >> 1].push_back(n);
+      }
+   }
+   _poRefs.assign(_nodes, 0);
+   for (size_t i = 0, n = aig.getOutputCount(); i < n; i++) {
+      _poLits.push_back(aig.getOutput(i));
+      _poRefs[aig.getOutput(i) >> 1]++;
+   }
+   _dead.assign(_nodes, 0);
+
+   CirPhaseScope prof(_mgr->getProfiler(), PHASE_SIM);
+   vector<CirSimData> v(_nodes);
+   _values.resize(_nodes * ODC_SIM_WORDS);
+   for (unsigned w = 0; w < ODC_SIM_WORDS; w++) {
+      for (unsigned n = 1; n <= _inputs; n++) v[n] = odcRandomData();
+      aig.simulate(v);
+      for (unsigned n = 0; n < _nodes; n++)
+         _values[n * ODC_SIM_WORDS + w] = v[n];
+   }
+
+   _winPos.assign(_nodes, 0);
+   _inWindow.assign(_nodes, 0);
+   _satVar.assign(_nodes, 0);
+   _care.resize(ODC_SIM_WORDS);
+}
+
+// from the POs back, so the cones left without fanouts are gone before
+// their turn
+void
+CirOdcSweeper::sweep()
+{
+   IdList cands;
+   for (unsigned n = _nodes - 1; n > _inputs; n--) {
+      if (_dead[n]) continue;
+      assert(!_fanouts[n].empty() || _poRefs[n]);
+
+      buildWindow(n);
+      // the patterns where n is observable
+      simWindow(n, 2 * n + 1);
+      for (unsigned w = 0; w < ODC_SIM_WORDS; w++) {
+         _care[w] = 0;
+         for (size_t i = 0, m = _roots.size(); i < m; i++)
+            _care[w] |= getWinValue(2 * _roots[i], w) ^ getValue(2 * _roots[i], w);
+      }
+
+      getCandidates(n, cands);
+      unsigned tries = 0;
+      for (size_t i = 0, m = cands.size(); i < m && tries < ODC_MAX_TRIES; i++) {
+         unsigned r = cands[i];
+         if (!matchCare(n, r)) continue;
+         tries++;
+         if (!prove(n, r)) continue;
+         if (_mgr->isVerbose())
+            cout << "ODC: " << ((r & 1) ? "!" : "")
+                 << _mgr->getAigGate(r >> 1)->getID() << " merging "
+                 << _mgr->getAigGate(n)->getID() << endl;
+         if ((r >> 1) == 0) _byConst++;
+         else _byNode++;
+         replace(n, r);
+         break;
+      }
+      for (size_t i = 0, m = _window.size(); i < m; i++)
+         _inWindow[_window[i]] = 0;
+   }
+}
+
+/*************************************************/
+/*   Private member functions of CirOdcSweeper   */
+/*************************************************/
+CirSimData
+CirOdcSweeper::getWinValue(unsigned lit, unsigned w) const
+{
+   unsigned n = lit >> 1;
+   if (!_inWindow[n]) return getValue(lit, w);
+   return _winValues[_winPos[n] * ODC_SIM_WORDS + w] ^ -(CirSimData)(lit & 1);
+}
+
+// the fanouts of n up to _levels away, at most ODC_MAX_WINDOW of them;
+// the roots are those with a fanout or a PO outside
+void
+CirOdcSweeper::buildWindow(unsigned n)
+{
+   _window.assign(1, n);
+   _inWindow[n] = 1;
+   for (unsigned d = 0, begin = 0; d < _levels; d++) {
+      unsigned end = _window.size();
+      for (unsigned i = begin; i < end; i++) {
+         const IdList& fos = _fanouts[_window[i]];
+         for (size_t j = 0, m = fos.size(); j < m; j++) {
+            if (_inWindow[fos[j]] || _window.size() == ODC_MAX_WINDOW) continue;
+            _inWindow[fos[j]] = 1;
+            _window.push_back(fos[j]);
+         }
+      }
+      begin = end;
+   }
+   // n is the first; a node comes after its fanins
+   sort(_window.begin(), _window.end());
+
+   _roots.clear();
+   for (size_t i = 0, m = _window.size(); i < m; i++) {
+      unsigned u = _window[i];
+      _winPos[u] = i;
+      bool root = (_poRefs[u] > 0);
+      for (size_t j = 0, k = _fanouts[u].size(); j < k && !root; j++)
+         root = !_inWindow[_fanouts[u][j]];
+      if (root) _roots.push_back(u);
+   }
+}
+
+// the window with n taking the value of lit
+void
+CirOdcSweeper::simWindow(unsigned n, unsigned lit)
+{
+   assert(_window[0] == n);
+   _winValues.resize(_window.size() * ODC_SIM_WORDS);
+   for (unsigned w = 0; w < ODC_SIM_WORDS; w++)
+      _winValues[w] = getValue(lit, w);
+   for (size_t i = 1, m = _window.size(); i < m; i++) {
+      unsigned u = _window[i];
+      for (unsigned w = 0; w < ODC_SIM_WORDS; w++)
+         _winValues[i * ODC_SIM_WORDS + w] =
+            getWinValue(_fanins[2 * u], w) & getWinValue(_fanins[2 * u + 1], w);
+   }
+}
+
+// n and lit agree wherever n is observable
+bool
+CirOdcSweeper::matchCare(unsigned n, unsigned lit) const
+{
+   for (unsigned w = 0; w < ODC_SIM_WORDS; w++)
+      if ((getValue(2 * n, w) ^ getValue(lit, w)) & _care[w]) return false;
+   return true;
+}
+
+// the constants, then the nodes one and two levels below n, both phases
+void
+CirOdcSweeper::getCandidates(unsigned n, IdList& cands) const
+{
+   cands.assign(1, 0);
+   cands.push_back(1);
+   IdList below;
+   for (unsigned j = 0; j < 2; j++)
+      below.push_back(_fanins[2 * n + j] >> 1);
+   for (unsigned j = 0; j < 2; j++) {
+      unsigned a = below[j];
+      if (!isAnd(a)) continue;
+      for (unsigned k = 0; k < 2; k++)
+         below.push_back(_fanins[2 * a + k] >> 1);
+   }
+   for (size_t i = 0, m = below.size(); i < m; i++) {
+      unsigned b = below[i];
+      if (b == 0 || find(below.begin(), below.begin() + i, b) != below.begin() + i)
+         continue;
+      cands.push_back(2 * b);
+      cands.push_back(2 * b + 1);
+   }
+}
+
+// no root of the window changes when n is replaced by lit; the window
+// is in the CNF twice, before and after
+bool
+CirOdcSweeper::prove(unsigned n, unsigned lit)
+{
+   CirPhaseScope prof(_mgr->getProfiler(), PHASE_CNF);
+   _satCalls++;
+   _solver.initialize();
+   for (size_t i = 0, m = _satNodes.size(); i < m; i++)
+      _satVar[_satNodes[i]] = 0;
+   _satNodes.clear();
+   _support = 0;
+
+   unsigned depth = _levels * ODC_DEPTH;
+   unsigned low = (_levelOf[n] > depth ? _levelOf[n] - depth : 0);
+   for (size_t i = 0, m = _window.size(); i < m; i++)
+      getSatVar(_window[i], low);
+   Var rv = getSatVar(lit >> 1, low);
+   bool rInv = lit & 1;
+
+   IdList after(_window.size(), 0);
+   for (size_t i = 1, m = _window.size(); i < m; i++) {
+      unsigned u = _window[i];
+      Var v[2];
+      bool inv[2];
+      for (unsigned j = 0; j < 2; j++) {
+         unsigned f = _fanins[2 * u + j];
+         inv[j] = f & 1;
+         if ((f >> 1) == n) { v[j] = rv; inv[j] ^= rInv; }
+         else if (_inWindow[f >> 1]) v[j] = after[_winPos[f >> 1]];
+         else v[j] = _satVar[f >> 1];
+      }
+      after[i] = _solver.newVar();
+      _solver.addAigCNF(after[i], v[0], inv[0], v[1], inv[1]);
+   }
+
+   CirPhaseScope sat(_mgr->getProfiler(), PHASE_SAT);
+   for (size_t i = 0, m = _roots.size(); i < m; i++) {
+      unsigned u = _roots[i];
+      Var x = _solver.newVar();
+      if (u == n) _solver.addXorCNF(x, rv, rInv, _satVar[n], false);
+      else _solver.addXorCNF(x, after[_winPos[u]], false, _satVar[u], false);
+      _solver.assumeRelease();
+      _solver.assumeProperty(x, true);
+      if (_solver.assumpSolve()) {
+         _refuted++;
+         return false;
+      }
+   }
+   return true;
+}
+
+// the nodes of the window and their fanins down to the given level, at
+// most ODC_MAX_SUPPORT of them; the others are free
+Var
+CirOdcSweeper::getSatVar(unsigned n, unsigned low)
+{
+   if (_satVar[n]) return _satVar[n];
+   Var v = _solver.newVar();
+   _satVar[n] = v;
+   _satNodes.push_back(n);
+   if (n == 0) _solver.assertProperty(v, false);
+   else if (isAnd(n) && (_inWindow[n] ||
+            (_levelOf[n] >= low && _support < ODC_MAX_SUPPORT))) {
+      if (!_inWindow[n]) _support++;
+      unsigned f0 = _fanins[2 * n], f1 = _fanins[2 * n + 1];
+      Var v0 = getSatVar(f0 >> 1, low);
+      Var v1 = getSatVar(f1 >> 1, low);
+      _solver.addAigCNF(v, v0, f0 & 1, v1, f1 & 1);
+   }
+   return v;
+}
+
+// the window takes its new values first; the roots keep theirs
+void
+CirOdcSweeper::replace(unsigned n, unsigned lit)
+{
+   simWindow(n, lit);
+   for (size_t i = 1, m = _window.size(); i < m; i++)
+      for (unsigned w = 0; w < ODC_SIM_WORDS; w++)
+         _values[_window[i] * ODC_SIM_WORDS + w] = _winValues[i * ODC_SIM_WORDS + w];
+
+   // one fanin per entry, as there are two for (x, !x)
+   IdList fos;
+   fos.swap(_fanouts[n]);
+   for (size_t i = 0, m = fos.size(); i < m; i++) {
+      unsigned f = fos[i];
+      for (unsigned j = 0; j < 2; j++) {
+         if ((_fanins[2 * f + j] >> 1) != n) continue;
+         _fanins[2 * f + j] = lit ^ (_fanins[2 * f + j] & 1);
+         _fanouts[lit >> 1].push_back(f);
+         break;
+      }
+   }
+   for (size_t i = 0, m = _poLits.size(); i < m; i++) {
+      if ((_poLits[i] >> 1) != n) continue;
+      _poLits[i] = lit ^ (_poLits[i] & 1);
+      _poRefs[lit >> 1]++;
+   }
+   _poRefs[n] = 0;
+
+   CirGate* g = _mgr->getAigGate(n);
+   CirGate* to = _mgr->getAigGate(lit >> 1);
+   bool inv = lit & 1;
+   GateVList gfos;
+   gfos.swap(g->_fanoutList);
+   for (size_t i = 0, m = gfos.size(); i < m; i++) {
+      CirGate* fo = (CirGate*)(gfos[i] & ~(CirGateV)1);
+      bool foInv = gfos[i] & 1;
+      for (size_t j = 0; j < fo->_faninCount; j++) {
+         if (fo->getFanin(j) == g && fo->getInv(j) == foInv) {
+            fo->setFanin(j, (CirGateV)to | (foInv ^ inv));
+            break;
+         }
+      }
+      to->addFanout((CirGateV)fo | (foInv ^ inv));
+   }
+   kill(n);
+}
+
+// n must be an AIG without fanouts; so are the fanins it leaves so
+void
+CirOdcSweeper::kill(unsigned n)
+{
+   assert(isAnd(n) && _fanouts[n].empty() && !_poRefs[n]);
+   _dead[n] = 1;
+   CirGate* g = _mgr->getAigGate(n);
+   for (unsigned j = 0; j < 2; j++) {
+      IdList& fos = _fanouts[_fanins[2 * n + j] >> 1];
+      fos.erase(find(fos.begin(), fos.end(), n));
+      g->getFanin(j)->eraseFanout(g);
+   }
+   for (unsigned j = 0; j < 2; j++) {
+      unsigned a = _fanins[2 * n + j] >> 1;
+      if (isAnd(a) && !_dead[a] && _fanouts[a].empty() && !_poRefs[a]) {
+         _removed++;
+         kill(a);
+      }
+   }
+   _mgr->eraseGate(g);
+}
@@ -0,0 +1,103 @@
+/****************************************************************************
+  FileName     [ cirOdc.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define redundancy removal by observability don't cares ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_ODC_H
+#define CIR_ODC_H
+
+#include <vector>
+#include "cirDef.h"
+#include "sat.h"
+
+using namespace std;
+
+const unsigned ODC_MAX_WINDOW  = 64;   // nodes of a window, at most
+const unsigned ODC_MAX_SUPPORT = 256;  // AIGs below a window in its CNF
+const unsigned ODC_DEPTH       = 4;    // their levels below the node, per window level
+const unsigned ODC_MAX_TRIES   = 4;    // SAT checks per node
+const unsigned ODC_SIM_WORDS   = 8;    // random patterns, in words per node
+
+//------------------------------------------------------------------------
+//   Redundancy removal with observability don't cares
+//------------------------------------------------------------------------
+// The AIGs of the core are visited from the POs back. The window of a
+// node is its fanouts up to a few levels; its roots are the nodes of the
+// window seen from outside (by fanouts or POs). Flipping the node on the
+// random patterns and simulating the window gives the patterns where it
+// is observable at a root. A constant or a node up to two levels below
+// that agrees with it on all of them is a candidate; SAT then checks that
+// no root of the window changes if the node is replaced by it, with the
+// nodes below the window cut into free variables. A few candidates are
+// checked at most, as the same unreachable leaf values refute them all.
+// Every replacement is applied at once, together with the nodes left
+// without fanouts, so each check is made on the circuit as it is.
+class CirOdcSweeper
+{
+public:
+   CirOdcSweeper(CirMgr* mgr, unsigned levels);
+   ~CirOdcSweeper() {}
+
+   void sweep();
+
+   unsigned getConstCount() const { return _byConst; }
+   unsigned getNodeCount() const { return _byNode; }
+   unsigned getRemovedCount() const { return _removed; }
+   unsigned getSatCount() const { return _satCalls; }
+   unsigned getRefutedCount() const { return _refuted; }
+
+private:
+   CirMgr*                 _mgr;
+   unsigned                _levels;
+   unsigned                _inputs;
+   unsigned                _nodes;
+   // the core, kept up to date with the gates
+   IdList                  _fanins;     // 2 per node
+   vector<IdList>          _fanouts;    // by fanin, so twice for (x, !x)
+   IdList                  _poLits;
+   IdList                  _poRefs;     // by node
+   IdList                  _levelOf;
+   vector<char>            _dead;
+   vector<CirSimData>      _values;     // ODC_SIM_WORDS per node
+
+   // the current window, in topological order
+   IdList                  _window;
+   IdList                  _roots;
+   IdList                  _winPos;     // by node; valid in the window only
+   vector<char>            _inWindow;
+   vector<CirSimData>      _winValues;  // ODC_SIM_WORDS per window node
+   vector<CirSimData>      _care;
+
+   SatSolver               _solver;
+   IdList                  _satVar;     // by node; 0 if not in the CNF
+   IdList                  _satNodes;
+   unsigned                _support;
+
+   unsigned                _byConst;
+   unsigned                _byNode;
+   unsigned                _removed;
+   unsigned                _satCalls;
+   unsigned                _refuted;
+
+   bool isAnd(unsigned n) const { return n > _inputs; }
+   CirSimData getValue(unsigned lit, unsigned w) const {
+      return _values[(lit >> 1) * ODC_SIM_WORDS + w] ^ -(CirSimData)(lit & 1);
+   }
+   CirSimData getWinValue(unsigned lit, unsigned w) const;
+
+   void buildWindow(unsigned);
+   void simWindow(unsigned, unsigned);
+   bool matchCare(unsigned, unsigned) const;
+   void getCandidates(unsigned, IdList&) const;
+
+   bool prove(unsigned, unsigned);
+   Var getSatVar(unsigned, unsigned);
+
+   void replace(unsigned, unsigned);
+   void kill(unsigned);
+};
+
+#endif // CIR_ODC_H
@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 #include "cirDef.h"
 #include "cirMgr.h"
 #include "cirGate.h"
@@ -25,6 +26,244 @@ using namespace std;
 /**************************************/
 /*   Static varaibles and functions   */
 /**************************************/
+//------------------------------------------------------------------------
+//   Rebuild AND supergates as trees balanced by the input levels
+//------------------------------------------------------------------------
+// A supergate is the tree of AIGs below a root that are only used by one
+// non-inverted AND. Roots are visited in topological order, so their
+// leaves are already balanced. The two lowest operands are paired first;
+// the AIGs created (and the roots) are strashed as they go.
+class CirBalancer
+{
+public:
+   CirBalancer(CirMgr* mgr);
+
+   void balance();
+
+   unsigned getDepth() const;
+
+private:
+   CirMgr*                          _mgr;
+   HashMap<CirStrashKey, CirGate*>  _strash;
+   IdList                           _level;    // by gate ID
+   IdList                           _freeIds;
+   unsigned                         _nextId;
+
+   unsigned getLevel(CirGateV v) const { return _level[((CirGate*)(v & ~(CirGateV)1))->getID()]; }
+   void setLevel(CirGate*, unsigned);
+   bool isInner(CirGate* g) const {
+      return g->isAig() && g->_fanoutList.size() == 1 && !g->getFanoutInv(0)
+             && g->getFanout(0)->isAig();
+   }
+
+   void balanceRoot(CirGate*);
+   bool simplifyAnd(CirGateV&, CirGateV&, CirGateV&) const;
+   CirGateV buildAnd(CirGateV, CirGateV);
+   void merge(CirGate*, CirGateV);
+};
+
+struct CirLevelCompFN
+{
+   CirLevelCompFN(const IdList& l): _level(l) {}
+   // higher levels first, the operands are taken from the back
+   bool operator() (CirGateV a, CirGateV b) const {
+      return _level[((CirGate*)(a & ~(CirGateV)1))->getID()]
+           > _level[((CirGate*)(b & ~(CirGateV)1))->getID()];
+   }
+   const IdList& _level;
+};
+
+CirBalancer::CirBalancer(CirMgr* mgr):
+   _mgr(mgr), _strash(getHashSize(mgr->_andGateCount * 5 / 3 + 1)), _nextId(0)
+{
+   unsigned last = 0;
+   for (GateMap::const_iterator it = _mgr->_gates.begin(); it != _mgr->_gates.end(); ++it) {
+      unsigned id = it->first;
+      for (unsigned i = last + 1; i < id && i <= _mgr->_maxNum; i++)
+         _freeIds.push_back(i);
+      last = id;
+   }
+   for (unsigned i = last + 1; i <= _mgr->_maxNum; i++)
+      _freeIds.push_back(i);
+   _nextId = (last > _mgr->_maxNum ? last : _mgr->_maxNum) + 1;
+   reverse(_freeIds.begin(), _freeIds.end());
+   _level.resize(_nextId, 0);
+}
+
+void
+CirBalancer::balance()
+{
+   // copy; the roots may be merged away
+   GateList l = _mgr->getDfsList();
+   for (size_t i = 0, n = l.size(); i < n; i++) {
+      CirGate* g = l[i];
+      if (!g->isAig()) continue;
+      if (isInner(g))
+         setLevel(g, std::max(getLevel(g->_fanin[0]), getLevel(g->_fanin[1])) + 1);
+      else balanceRoot(g);
+   }
+
+   unsigned maxId = _mgr->_maxNum;
+   for (GateMap::const_iterator it = _mgr->_gates.begin(); it != _mgr->_gates.end(); ++it)
+      if (it->second->isAig() && it->first > maxId)
+         maxId = it->first;
+   _mgr->_maxNum = maxId;
+}
+
+unsigned
+CirBalancer::getDepth() const
+{
+   unsigned depth = 0;
+   for (size_t i = 0, n = _mgr->_poList.size(); i < n; i++)
+      depth = std::max(depth, getLevel(_mgr->_poList[i]->_fanin[0]));
+   return depth;
+}
+
+void
+CirBalancer::setLevel(CirGate* g, unsigned l)
+{
+   if (g->getID() >= _level.size()) _level.resize(g->getID() + 1, 0);
+   _level[g->getID()] = l;
+}
+
+void
+CirBalancer::balanceRoot(CirGate* root)
+{
+   GateVList leaves;
+   GateList inner;
+   GateVList stack(root->_fanin, root->_fanin + 2);
+   while (!stack.empty()) {
+      CirGateV v = stack.back();
+      stack.pop_back();
+      CirGate* g = (CirGate*)(v & ~(CirGateV)1);
+      if (!(v & 1) && isInner(g)) {
+         inner.push_back(g);
+         stack.push_back(g->_fanin[0]);
+         stack.push_back(g->_fanin[1]);
+      } else leaves.push_back(v);
+   }
+
+   // detach the old tree; the root itself is kept for its fanouts
+   root->getFanin(0)->eraseFanout(root);
+   root->getFanin(1)->eraseFanout(root);
+   for (size_t i = 0, n = inner.size(); i < n; i++) {
+      inner[i]->getFanin(0)->eraseFanout(inner[i]);
+      inner[i]->getFanin(1)->eraseFanout(inner[i]);
+   }
+   for (size_t i = 0, n = inner.size(); i < n; i++) {
+      // balanced as a root before it lost the other fanouts
+      _strash.remove(CirStrashKey(inner[i]), inner[i]);
+      _freeIds.push_back(inner[i]->getID());
+      _mgr->eraseGate(inner[i]);
+   }
+
+   // x & x = x, x & !x = 0 and the constants
+   CirGateV const0 = (CirGateV)_mgr->getGate(0);
+   sort(leaves.begin(), leaves.end());
+   size_t k = 0;
+   for (size_t i = 0, n = leaves.size(); i < n; i++) {
+      if (leaves[i] == (const0 | 1)) continue;
+      if (leaves[i] == const0 || (k && (leaves[k - 1] ^ leaves[i]) == 1)) {
+         merge(root, const0);
+         return;
+      }
+      if (k && leaves[k - 1] == leaves[i]) continue;
+      leaves[k++] = leaves[i];
+   }
+   leaves.resize(k);
+   if (leaves.empty()) { merge(root, const0 | 1); return; }
+   if (leaves.size() == 1) { merge(root, leaves[0]); return; }
+
+   CirLevelCompFN levelComp(_level);
+   while (leaves.size() > 2) {
+      stable_sort(leaves.begin(), leaves.end(), levelComp);
+      CirGateV a = leaves.back(); leaves.pop_back();
+      CirGateV b = leaves.back(); leaves.pop_back();
+      leaves.push_back(buildAnd(a, b));
+   }
+
+   // the root takes the last AND, unless it already exists
+   CirGateV a = leaves[0], b = leaves[1], v;
+   CirGate* t = 0;
+   if (simplifyAnd(a, b, v)) { merge(root, v); return; }
+   CirStrashKey key((CirGate*)(a & ~(CirGateV)1), a & 1, (CirGate*)(b & ~(CirGateV)1), b & 1);
+   if (_strash.check(key, t)) { merge(root, (CirGateV)t); return; }
+
+   root->_faninCount = 0;
+   root->addFanin(a);
+   root->addFanin(b);
+   ((CirGate*)(a & ~(CirGateV)1))->addFanout((CirGateV)root | (a & 1));
+   ((CirGate*)(b & ~(CirGateV)1))->addFanout((CirGateV)root | (b & 1));
+   _strash.forceInsert(key, root);
+   setLevel(root, std::max(getLevel(a), getLevel(b)) + 1);
+}
+
+// the rules of optimize(); true if a & b is simplified to v
+bool
+CirBalancer::simplifyAnd(CirGateV& a, CirGateV& b, CirGateV& v) const
+{
+   CirGateV const0 = (CirGateV)_mgr->getGate(0);
+   if (b == const0 || b == (const0 | 1)) swap(a, b);
+   if (a == const0 || (a ^ b) == 1) { v = const0; return true; }
+   if (a == (const0 | 1) || a == b) { v = b; return true; }
+   return false;
+}
+
+CirGateV
+CirBalancer::buildAnd(CirGateV a, CirGateV b)
+{
+   CirGateV v;
+   if (simplifyAnd(a, b, v)) return v;
+
+   CirGate* ga = (CirGate*)(a & ~(CirGateV)1);
+   CirGate* gb = (CirGate*)(b & ~(CirGateV)1);
+   CirStrashKey key(ga, a & 1, gb, b & 1);
+   CirGate* g = 0;
+   if (_strash.check(key, g)) return (CirGateV)g;
+
+   unsigned id;
+   if (_freeIds.empty()) id = _nextId++;
+   else {
+      id = _freeIds.back();
+      _freeIds.pop_back();
+   }
+   g = new AigGate(id, 0);
+   g->addFanin(a);
+   g->addFanin(b);
+   ga->addFanout((CirGateV)g | (a & 1));
+   gb->addFanout((CirGateV)g | (b & 1));
+   _mgr->_gates[id] = g;
+   _mgr->_andGateCount++;
+   _strash.forceInsert(key, g);
+   setLevel(g, std::max(getLevel(a), getLevel(b)) + 1);
+   return (CirGateV)g;
+}
+
+// move the fanouts of the (detached) root to v and delete it
+void
+CirBalancer::merge(CirGate* root, CirGateV v)
+{
+   CirGate* to = (CirGate*)(v & ~(CirGateV)1);
+   for (size_t i = 0, n = root->_fanoutList.size(); i < n; i++) {
+      CirGate* fo = root->getFanout(i);
+      bool foInv = root->getFanoutInv(i);
+      for (size_t j = 0; j < fo->_faninCount; j++) {
+         if (fo->getFanin(j) == root && fo->getInv(j) == foInv) {
+            fo->setFanin(j, v ^ foInv);
+            break;
+         }
+      }
+      to->addFanout((CirGateV)fo | ((v & 1) ^ foInv));
+   }
+   root->_faninCount = 0;
+   _mgr->eraseGate(root);
+}
+
+// unused by the POs after a DFS
+static inline bool isSwept(const CirGate* g)
+{
+   return (g->_type == UNDEF_GATE || g->isAig()) && !g->isMarked();
+}
 
 /**************************************************/
 /*   Public member functions about optimization   */
@@ -32,28 +271,59 @@ using namespace std;
 // Remove unused gates
 // DFS list should NOT be changed
 // UNDEF, float and unused list may be changed
+// The gates not marked by the DFS are taken out of the map in one pass;
+// the fanout lists of the gates left are then filtered once each, in
+// their order, and the dead gates deleted together. With `quiet`, or
+// below CIR_VERB_ITEM, only the numbers removed are reported.
 void
-CirMgr::sweep()
+CirMgr::sweep(bool quiet)
 {
    // Output Example:
    // Sweeping: AIG(XX) removed...
+   // Sweeping: 12 gates removed (10 AIGs, 2 UNDEFs)
+   CirPhaseScope prof(_profiler, PHASE_SWEEP);
+   // isSwept() reads the DFS marks, which other traversals may have
+   // cleared since the list was cached; mark the live gates again
+   _dfsList_clean = false;
    getDfsList();
+   quiet = quiet || !isVerbose();
 
+   GateList dead;
+   unsigned aigs = 0;
    GateMap::iterator it = _gates.begin();
    while (it != _gates.end()) {
       CirGate* g = (*it).second;
-      if ((g->_type == UNDEF_GATE || g->isAig()) && !g->isMarked()) {
-         cout << "Sweeping: " << g->getTypeStr() << "(" << g->getID() << ") removed..." << endl;
-
-         // remove it from other items' fanouts
-         for (size_t i = 0; i < g->_faninCount; i++)
-            assert(g->getFanin(i)->eraseFanout(g));
-
+      if (isSwept(g)) {
+         if (!quiet)
+            cout << "Sweeping: " << g->getTypeStr() << "(" << g->getID() << ") removed..." << endl;
+         dead.push_back(g);
+         if (g->isAig()) aigs++;
          _gates.erase(it++);
-         if (g->isAig())
-            _andGateCount--;
       } else ++it;
    }
+   _andGateCount -= aigs;
+
+   // the live fanins of the dead gates lose those fanouts
+   GateList touched;
+   for (size_t i = 0, n = dead.size(); i < n; i++)
+      for (size_t j = 0; j < dead[i]->_faninCount; j++)
+         if (!isSwept(dead[i]->getFanin(j)))
+            touched.push_back(dead[i]->getFanin(j));
+   sort(touched.begin(), touched.end());
+   touched.erase(unique(touched.begin(), touched.end()), touched.end());
+   for (size_t i = 0, n = touched.size(); i < n; i++) {
+      GateVList& fo = touched[i]->_fanoutList;
+      size_t cnt = 0;
+      for (size_t j = 0, m = fo.size(); j < m; j++)
+         if (!isSwept((CirGate*)(fo[j] & ~(CirGateV)1))) fo[cnt++] = fo[j];
+      fo.resize(cnt);
+   }
+   for (size_t i = 0, n = dead.size(); i < n; i++)
+      delete dead[i];
+
+   if (quiet && !isSilent())
+      cout << "Sweeping: " << dead.size() << " gates removed (" << aigs
+           << " AIGs, " << dead.size() - aigs << " UNDEFs)" << endl;
 
    #ifdef CHECK_INTEGRITY
    checkIntegrity();
@@ -68,8 +338,11 @@ CirMgr::optimize()
 {
    // Output Example:
    // Simplifying: XX merging (!)YY...
+   // Simplifying: 12 AIGs merged
+   CirPhaseScope prof(_profiler, PHASE_OPT);
 
    bool structChanged = false;
+   unsigned merged = 0;
 
    CirGate *ga, *gb;
    CirGate* gnew;
@@ -102,23 +375,26 @@ CirMgr::optimize()
       } else continue;
 
       structChanged = true;
+      merged++;
 
       // not checking for duplicating
       ga->eraseFanout(_dfsList[i]);
       gb->eraseFanout(_dfsList[i]);
 
       // print out the reason if available
-      cout << "Simplifying: " << gnew->getID() << " merging ";
-      if (inew) cout << "!";
-      cout << _dfsList[i]->getID() << "...";
-
-      #ifdef VERBOSE
-      cout << " ["
-           << (ia ? "!" : "") << ga->getID() << ","
-           << (ib ? "!" : "") << gb->getID() << "]";
-      #endif  // VERBOSE
-
-      cout << endl;
+      if (isVerbose()) {
+         cout << "Simplifying: " << gnew->getID() << " merging ";
+         if (inew) cout << "!";
+         cout << _dfsList[i]->getID() << "...";
+
+         #ifdef VERBOSE
+         cout << " ["
+              << (ia ? "!" : "") << ga->getID() << ","
+              << (ib ? "!" : "") << gb->getID() << "]";
+         #endif  // VERBOSE
+
+         cout << endl;
+      }
 
       // (ga, gb)--(Y)-->(Zi) to (Y*)-->(Zi)
       for (size_t j = 0, n = _dfsList[i]->_fanoutList.size(); j < n; j++) {
@@ -126,13 +402,15 @@ CirMgr::optimize()
          // add Zi to (Y*)s' fanout...
          gnew->addFanout((CirGateV) _dfsList[i]->getFanout(j) | new_inv);
          // replace (Zi)s' fanin to (Y*)... w/ phase applied
-         _dfsList[i]->getFanout(j)->replaceFanin(_dfsList[i], (CirGateV)gnew | new_inv);
+         _dfsList[i]->getFanout(j)->replaceFanin(_dfsList[i], (CirGateV)gnew | inew);
          // cout << "  replacing fanin of " << _dfsList[i]->getFanout(j)->getID()
          //      << " with inv=" << new_inv << endl;
       }
 
       eraseGate(_dfsList[i]);
    }
+   if (!isVerbose() && !isSilent())
+      cout << "Simplifying: " << merged << " AIGs merged" << endl;
 
    #ifdef CHECK_INTEGRITY
    checkIntegrity();
@@ -142,9 +420,44 @@ CirMgr::optimize()
       _dfsList_clean = false;
 }
 
+// Rebuild the AND supergates as trees balanced by the input levels
+// _dfsList needs to be reconstructed afterwards
+void
+CirMgr::balance()
+{
+   // Output Example:
+   // Balancing: depth XX -> YY, AIGs XX -> YY
+   CirPhaseScope prof(_profiler, PHASE_BALANCE);
+   unsigned before = _andGateCount;
+   CirBalancer bal(this);
+   // the levels are only known while balancing; count the old depth first
+   unsigned depth = getDepth();
+   if (!_balanced) _depthBefore = depth;
+   bal.balance();
+   _depthAfter = bal.getDepth();
+   _balanced = true;
+   _dfsList_clean = false;
+   // the proof model has no variables for the new AIGs
+   delete _satSolver;
+   _satSolver = 0;
+
+   cout << "Balancing: depth " << depth << " -> " << _depthAfter
+        << ", AIGs " << before << " -> " << _andGateCount << endl;
+
+   #ifdef CHECK_INTEGRITY
+   checkIntegrity();
+   #endif  // CHECK_INTEGRITY
+}
+
 /***************************************************/
 /*   Private member functions about optimization   */
 /***************************************************/
+// the largest #AIGs on a path from a PI to a PO
+unsigned
+CirMgr::getDepth() const
+{
+   return getAig().getDepth();
+}
 
 #ifdef CHECK_INTEGRITY
 enum IntegrityState {
@@ -0,0 +1,297 @@
+/****************************************************************************
+  FileName     [ cirPattern.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the pattern file reader and the simulation log ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cctype>
+#include <cstring>
+#include <iterator>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "cirPattern.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// pack a string of 0/1 (at most SIM_BITS of them) into the bits of w,
+// character k to bit k; false if there is any other character.
+// 8 characters are checked and packed at a time (in little endian).
+static bool packText(const char* s, size_t n, CirSimData& w)
+{
+   const unsigned long long lowBits = 0x0101010101010101ULL;
+   w = 0;
+   size_t k = 0;
+   for (; k + 8 <= n; k += 8) {
+      unsigned long long x;
+      memcpy(&x, s + k, 8);
+      if ((x & ~lowBits) != 0x3030303030303030ULL) return false;
+      x = ((x & lowBits) * 0x0102040810204080ULL) >> 56;
+      w |= (CirSimData)x << k;
+   }
+   for (; k < n; k++) {
+      if (s[k] != '0' && s[k] != '1') return false;
+      if (s[k] == '1') w |= (CirSimData)1 << k;
+   }
+   return true;
+}
+
+// the characters of the bits of a byte, from bit 0
+static char bitChars[256][8];
+static bool bitCharsReady = false;
+
+static void buildBitChars()
+{
+   if (bitCharsReady) return;
+   for (unsigned b = 0; b < 256; b++)
+      for (unsigned k = 0; k < 8; k++)
+         bitChars[b][k] = (b >> k & 1) ? '1' : '0';
+   bitCharsReady = true;
+}
+
+static void putWord4(char* s, unsigned w)
+{
+   for (unsigned k = 0; k < 4; k++)
+      s[k] = (char)(w >> (8 * k));
+}
+
+// a[i] bit j <-> a[j] bit i, by swapping the off-diagonal blocks of
+// halving sizes
+static void transposeBlock(CirSimData* a)
+{
+   unsigned j = SIM_BITS / 2;
+   CirSimData m = ~(CirSimData)0 >> j;
+   for (; j; j >>= 1, m ^= m << j) {
+      for (unsigned k = 0; k < SIM_BITS; k = ((k | j) + 1) & ~j) {
+         CirSimData t = ((a[k] >> j) ^ a[k | j]) & m;
+         a[k | j] ^= t;
+         a[k] ^= t << j;
+      }
+   }
+}
+
+/**********************************************/
+/*   class CirPatternReader member functions  */
+/**********************************************/
+CirPatternReader::CirPatternReader():
+   _data(0), _size(0), _pos(0), _mapped(false), _binary(false), _width(0) {}
+
+bool
+CirPatternReader::open(const string& fileName)
+{
+   close();
+   int fd = ::open(fileName.c_str(), O_RDONLY);
+   if (fd < 0) return false;
+
+   struct stat st;
+   if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      void* p = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+         madvise(p, st.st_size, MADV_SEQUENTIAL);
+         _data = (const char*)p;
+         _size = st.st_size;
+         _mapped = true;
+      }
+   }
+   ::close(fd);
+
+   // not a regular file, or it cannot be mapped
+   if (!_mapped) {
+      ifstream ifs(fileName.c_str(), ios::in | ios::binary);
+      if (!ifs) return false;
+      _buf.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+      _data = (_buf.empty() ? 0 : &_buf[0]);
+      _size = _buf.size();
+   }
+
+   _binary = (_size >= sizeof(PAT_BIN_MAGIC) &&
+              memcmp(_data, PAT_BIN_MAGIC, sizeof(PAT_BIN_MAGIC)) == 0);
+   if (_binary) {
+      _width = 0;
+      for (size_t i = 0; i < 4 && 4 + i < _size; i++)
+         _width |= (size_t)(unsigned char)_data[4 + i] << (8 * i);
+      _pos = (PAT_BIN_HEADER < _size ? PAT_BIN_HEADER : _size);
+   }
+   return true;
+}
+
+void
+CirPatternReader::close()
+{
+   if (_mapped) munmap((void*)_data, _size);
+   _buf.clear();
+   _data = 0;
+   _size = _pos = 0;
+   _mapped = _binary = false;
+   _width = 0;
+}
+
+int
+CirPatternReader::read(CirSimData* words, size_t piSize)
+{
+   size_t chunks = (piSize + SIM_BITS - 1) / SIM_BITS;
+   _rows.assign(chunks * SIM_BITS, 0);
+
+   int n = (_binary ? readBinary(piSize) : readText(piSize));
+   if (n > 0) transpose(words, piSize);
+   return n;
+}
+
+/****************************************************/
+/*   Private member functions of CirPatternReader   */
+/****************************************************/
+// pattern p of the block goes to the rows of index SIM_BITS - 1 - p,
+// hence to the bits from the highest one
+int
+CirPatternReader::readText(size_t piSize)
+{
+   int n = 0;
+   while (n < (int)SIM_BITS) {
+      while (_pos < _size && isspace((unsigned char)_data[_pos])) _pos++;
+      if (_pos == _size) break;
+      const char* s = _data + _pos;
+      size_t len = 0;
+      while (_pos < _size && !isspace((unsigned char)_data[_pos])) {
+         _pos++;
+         len++;
+      }
+
+      if (len != piSize) {
+         cerr << "Error: Pattern(" << string(s, len) << ") length(" << len
+            << ") does not match the number of inputs(" << piSize
+            << ") in a circuit!!" << endl;
+         return -1;
+      }
+      for (size_t c = 0, b = 0; b < len; c++, b += SIM_BITS) {
+         size_t m = (len - b < SIM_BITS ? len - b : SIM_BITS);
+         if (packText(s + b, m, _rows[c * SIM_BITS + SIM_BITS - 1 - n])) continue;
+         size_t k = b;
+         while (s[k] == '0' || s[k] == '1') k++;
+         cerr << "Error: Pattern(" << string(s, len) << ") contains a non-0/1 character('"
+              << s[k] << "')." << endl;
+         return -1;
+      }
+      n++;
+   }
+   return n;
+}
+
+int
+CirPatternReader::readBinary(size_t piSize)
+{
+   if (_width != piSize) {
+      cerr << "Error: Pattern length(" << _width
+           << ") does not match the number of inputs(" << piSize
+           << ") in a circuit!!" << endl;
+      return -1;
+   }
+   size_t bytes = (piSize + 7) / 8;
+   int n = 0;
+   for (; n < (int)SIM_BITS && _pos < _size; n++) {
+      if (_size - _pos < bytes) {
+         cerr << "Error: Pattern file ends in the middle of a pattern!!" << endl;
+         return -1;
+      }
+      const unsigned char* s = (const unsigned char*)_data + _pos;
+      for (size_t c = 0, b = 0; b < bytes; c++, b += SIM_BITS / 8) {
+         CirSimData& w = _rows[c * SIM_BITS + SIM_BITS - 1 - n];
+         for (size_t k = 0; k < SIM_BITS / 8 && b + k < bytes; k++)
+            w |= (CirSimData)s[b + k] << (8 * k);
+      }
+      _pos += bytes;
+   }
+   return n;
+}
+
+void
+CirPatternReader::transpose(CirSimData* words, size_t piSize)
+{
+   for (size_t c = 0, b = 0; b < piSize; c++, b += SIM_BITS) {
+      CirSimData* a = &_rows[c * SIM_BITS];
+      transposeBlock(a);
+      for (size_t k = 0; k < SIM_BITS && b + k < piSize; k++)
+         words[b + k] = a[k];
+   }
+}
+
+/***************************************/
+/*   class CirSimLog member functions  */
+/***************************************/
+CirSimLog::CirSimLog(ostream& os, size_t nIn, size_t nOut, bool binary):
+   _os(os), _nIn(nIn), _nOut(nOut), _binary(binary)
+{
+   _lineSize = (_binary ? (nIn + 7) / 8 + (nOut + 7) / 8 : nIn + nOut + 2);
+   _buf.resize(SIM_BITS * _lineSize);
+   if (_binary) {
+      char header[12];
+      memcpy(header, LOG_BIN_MAGIC, sizeof(LOG_BIN_MAGIC));
+      putWord4(header + 4, nIn);
+      putWord4(header + 8, nOut);
+      _os.write(header, sizeof(header));
+   }
+   else {
+      buildBitChars();
+      for (size_t p = 0; p < SIM_BITS; p++) {
+         _buf[p * _lineSize + nIn] = ' ';
+         _buf[(p + 1) * _lineSize - 1] = '\n';
+      }
+   }
+}
+
+void
+CirSimLog::write(const CirSimData* in, const CirSimData* out, unsigned count)
+{
+   assert(count <= SIM_BITS);
+   if (_binary) {
+      putRows(in, _nIn, 0);
+      putRows(out, _nOut, (_nIn + 7) / 8);
+   }
+   else {
+      putRows(in, _nIn, 0);
+      putRows(out, _nOut, _nIn + 1);
+   }
+   _os.write(&_buf[0], count * _lineSize);
+}
+
+// the bits of n words into the lines of the block, from `offset` of each
+void
+CirSimLog::putRows(const CirSimData* words, size_t n, size_t offset)
+{
+   for (size_t b = 0; b < n; b += SIM_BITS) {
+      size_t m = (n - b < SIM_BITS ? n - b : SIM_BITS);
+      for (size_t k = 0; k < SIM_BITS; k++)
+         _square[k] = (k < m ? words[b + k] : 0);
+      transposeBlock(_square);
+
+      // _square[SIM_BITS - 1 - p] has bit k of input b + k in pattern p
+      for (size_t p = 0; p < SIM_BITS; p++) {
+         CirSimData row = _square[SIM_BITS - 1 - p];
+         char* s = &_buf[p * _lineSize + offset];
+         if (_binary) {
+            s += b / 8;
+            for (size_t k = 0; k < m; k += 8)
+               s[k / 8] = (char)(row >> k);
+            continue;
+         }
+         s += b;
+         size_t k = 0;
+         for (; k + 8 <= m; k += 8)
+            memcpy(s + k, bitChars[(row >> k) & 0xFF], 8);
+         if (k < m)
+            memcpy(s + k, bitChars[(row >> k) & 0xFF], m - k);
+      }
+   }
+}
@@ -0,0 +1,96 @@
+/****************************************************************************
+  FileName     [ cirPattern.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the pattern file reader and the simulation log ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_PATTERN_H
+#define CIR_PATTERN_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include "cirDef.h"
+
+using namespace std;
+
+// A binary pattern file starts with these 4 bytes and the #inputs as a
+// 4-byte little endian number. Each pattern follows in (#inputs + 7) / 8
+// bytes, input i being bit (i % 8) of byte i / 8.
+const char     PAT_BIN_MAGIC[4]  = { 'P', 'A', 'T', 'B' };
+const size_t   PAT_BIN_HEADER    = 8;
+
+// A binary simulation log starts with these 4 bytes, the #inputs and the
+// #outputs, both 4-byte little endian numbers. Each pattern follows as in
+// a binary pattern file, and then its outputs in the same way.
+const char     LOG_BIN_MAGIC[4]  = { 'L', 'O', 'G', 'B' };
+
+//------------------------------------------------------------------------
+//   Read pattern files by blocks of SIM_BITS patterns
+//------------------------------------------------------------------------
+// The file is mapped into memory (or read at once if it cannot be). Text
+// patterns are whitespace separated strings of 0/1, one character per
+// input; binary ones are as described above. A block is first packed into
+// rows (a pattern over SIM_BITS inputs each), and every square of rows is
+// then transposed into the words of its inputs.
+class CirPatternReader
+{
+public:
+   CirPatternReader();
+   ~CirPatternReader() { close(); }
+
+   bool open(const string& fileName);
+   void close();
+   bool isBinary() const { return _binary; }
+
+   // put the next patterns into the highest bits of the words of the
+   // inputs and return how many there are (at most SIM_BITS); the other
+   // bits are cleared. -1 if the block has an error, which is reported.
+   int read(CirSimData* words, size_t piSize);
+
+private:
+   const char*          _data;
+   size_t               _size;
+   size_t               _pos;
+   bool                 _mapped;
+   vector<char>         _buf;       // if not mapped
+   bool                 _binary;
+   size_t               _width;     // #inputs in a binary file
+   vector<CirSimData>   _rows;      // by chunk of SIM_BITS inputs, then pattern
+
+   int readText(size_t piSize);
+   int readBinary(size_t piSize);
+   void transpose(CirSimData* words, size_t piSize);
+};
+
+//------------------------------------------------------------------------
+//   Write the simulation log by blocks of SIM_BITS patterns
+//------------------------------------------------------------------------
+// The words of each square of inputs (or outputs) are transposed into
+// rows, which are spread into the characters of the lines of the block
+// (or the bytes of its records); the block then goes to the stream in a
+// single write. The text lines are "<inputs> <outputs>", as 0/1.
+class CirSimLog
+{
+public:
+   CirSimLog(ostream& os, size_t nIn, size_t nOut, bool binary = false);
+   ~CirSimLog() {}
+
+   // the patterns in the `count` highest bits of the words
+   void write(const CirSimData* in, const CirSimData* out, unsigned count);
+
+private:
+   ostream&             _os;
+   size_t               _nIn;
+   size_t               _nOut;
+   bool                 _binary;
+   size_t               _lineSize;   // bytes per pattern
+   vector<char>         _buf;        // of a block
+   CirSimData           _square[SIM_BITS];
+
+   void putRows(const CirSimData* words, size_t n, size_t offset);
+};
+
+#endif // CIR_PATTERN_H
@@ -0,0 +1,282 @@
+/****************************************************************************
+  FileName     [ cirProfile.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define per-phase time and memory profiling ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include <sys/resource.h>
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#define malloc_usable_size malloc_size
+#else
+#include <malloc.h>
+#endif
+#include "cirProfile.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// by thread, so that nothing is shared; a parallel fraig merges the
+// profilers of its threads into that of the circuit
+static __thread CirAllocCount allocCount = { 0, 0, 0, 0 };
+
+static const char* phaseStr[PHASE_TOT] = {
+   "parse", "initialize", "dfs", "strash", "optimize", "sweep",
+   "rewrite", "balance", "simulate", "fec", "cnf", "sat"
+};
+
+static double wallTime()
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// of this thread only, so that the jobs of a parallel fraig add up
+static double cpuSeconds()
+{
+   struct timespec t;
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+   return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// as MyUsage::checkMem()
+static double maxResident()
+{
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+   return usage.ru_maxrss / double(1 << 20);
+#else
+   return usage.ru_maxrss / double(1 << 10);
+#endif
+}
+
+static double toMB(double bytes) { return bytes / double(1 << 20); }
+
+/*****************************************/
+/*   Counting allocations by operator new */
+/*****************************************/
+// Every form is replaced, so that all of them take memory from malloc()
+// and give it back with free(); a form left to the library could free
+// what another one allocated.
+static void* countedAlloc(size_t n)
+{
+   void* p = malloc(n ? n : 1);
+   if (!p) return 0;
+   size_t s = malloc_usable_size(p);
+   allocCount._count++;
+   allocCount._bytes += s;
+   allocCount._live += s;
+   if (allocCount._live > allocCount._peak) allocCount._peak = allocCount._live;
+   return p;
+}
+
+static void countedFree(void* p)
+{
+   if (!p) return;
+   allocCount._live -= malloc_usable_size(p);
+   free(p);
+}
+
+void* operator new(size_t n)
+{
+   void* p = countedAlloc(n);
+   if (!p) throw bad_alloc();
+   return p;
+}
+
+void* operator new[](size_t n)
+{
+   void* p = countedAlloc(n);
+   if (!p) throw bad_alloc();
+   return p;
+}
+
+void* operator new(size_t n, const nothrow_t&) throw() { return countedAlloc(n); }
+void* operator new[](size_t n, const nothrow_t&) throw() { return countedAlloc(n); }
+
+void operator delete(void* p) throw() { countedFree(p); }
+void operator delete[](void* p) throw() { countedFree(p); }
+void operator delete(void* p, const nothrow_t&) throw() { countedFree(p); }
+void operator delete[](void* p, const nothrow_t&) throw() { countedFree(p); }
+void operator delete(void* p, size_t) throw() { countedFree(p); }
+void operator delete[](void* p, size_t) throw() { countedFree(p); }
+
+const CirAllocCount& getAllocCount() { return allocCount; }
+
+void resetAllocPeak() { allocCount._peak = allocCount._live; }
+
+/*****************************************/
+/*   class CirProfiler member functions  */
+/*****************************************/
+void
+CirProfiler::reset()
+{
+   memset(_stats, 0, sizeof(_stats));
+   // the phases running go on from now
+   for (size_t i = 0, n = _stack.size(); i < n; i++) {
+      _stack[i]._callWall = 0;
+      resume(_stack[i]);
+   }
+}
+
+void
+CirProfiler::start(CirPhase p)
+{
+   if (!_stack.empty()) pause(_stack.back());
+   Frame f;
+   f._phase = p;
+   f._callWall = 0;
+   _stack.push_back(f);
+   resume(_stack.back());
+}
+
+void
+CirProfiler::stop()
+{
+   assert(!_stack.empty());
+   Frame& f = _stack.back();
+   pause(f);
+   CirPhaseStat& s = _stats[f._phase];
+   s._calls++;
+   if (f._callWall > s._maxWall) s._maxWall = f._callWall;
+   _stack.pop_back();
+   if (!_stack.empty()) resume(_stack.back());
+}
+
+// Add the records of another profiler, e.g. of a circuit fraiged in a
+// thread of its own. The times of phases run side by side add up, as
+// CPU times do; the peak is the highest of any single thread.
+void
+CirProfiler::merge(const CirProfiler& p)
+{
+   for (int i = 0; i < PHASE_TOT; i++) {
+      CirPhaseStat& s = _stats[i];
+      const CirPhaseStat& t = p._stats[i];
+      s._calls += t._calls;
+      s._wall += t._wall;
+      s._cpu += t._cpu;
+      if (t._maxWall > s._maxWall) s._maxWall = t._maxWall;
+      s._allocs += t._allocs;
+      s._allocBytes += t._allocBytes;
+      if (t._peakHeap > s._peakHeap) s._peakHeap = t._peakHeap;
+   }
+}
+
+const char*
+CirProfiler::getPhaseStr(CirPhase p)
+{
+   return phaseStr[p];
+}
+
+/*********************
+Phase         Calls     Wall(s)      CPU(s)   MaxCall(s)     Allocs   Alloc(MB)    Peak(MB)
+-------------------------------------------------------------------------------------------
+parse             1      0.0123      0.0120       0.0123      12345       1.234       2.345
+...
+-------------------------------------------------------------------------------------------
+Total                    0.0456      0.0450                   23456       3.456
+Max resident memory: 12.34 MB
+*********************/
+void
+CirProfiler::report(ostream& os) const
+{
+   const int w = 91;
+   ios::fmtflags flags = os.flags();
+   streamsize prec = os.precision();
+   os << left << setw(10) << "Phase" << right << setw(9) << "Calls"
+      << setw(12) << "Wall(s)" << setw(12) << "CPU(s)" << setw(13) << "MaxCall(s)"
+      << setw(11) << "Allocs" << setw(12) << "Alloc(MB)" << setw(12) << "Peak(MB)"
+      << endl << string(w, '-') << endl;
+
+   double wall = 0, cpu = 0;
+   size_t allocs = 0, bytes = 0;
+   os << fixed;
+   for (int i = 0; i < PHASE_TOT; i++) {
+      const CirPhaseStat& s = _stats[i];
+      os << left << setw(10) << phaseStr[i] << right << setw(9) << s._calls
+         << setprecision(4) << setw(12) << s._wall << setw(12) << s._cpu
+         << setw(13) << s._maxWall << setw(11) << s._allocs
+         << setprecision(3) << setw(12) << toMB(s._allocBytes)
+         << setw(12) << toMB(s._peakHeap) << endl;
+      wall += s._wall;
+      cpu += s._cpu;
+      allocs += s._allocs;
+      bytes += s._allocBytes;
+   }
+   os << string(w, '-') << endl
+      << left << setw(19) << "Total" << right << setprecision(4)
+      << setw(12) << wall << setw(12) << cpu << setw(13) << "" << setw(11) << allocs
+      << setprecision(3) << setw(12) << toMB(bytes) << endl
+      << "Max resident memory: " << setprecision(2) << maxResident() << " MB"
+      << endl;
+   os.flags(flags);
+   os.precision(prec);
+}
+
+// one object per phase, in the order of CirPhase
+void
+CirProfiler::reportJson(ostream& os) const
+{
+   ios::fmtflags flags = os.flags();
+   streamsize prec = os.precision();
+   os << "{" << endl << "  \"phases\": [" << endl << fixed;
+   for (int i = 0; i < PHASE_TOT; i++) {
+      const CirPhaseStat& s = _stats[i];
+      os << "    { \"phase\": \"" << phaseStr[i] << "\", \"calls\": " << s._calls
+         << setprecision(6) << ", \"wall\": " << s._wall << ", \"cpu\": " << s._cpu
+         << ", \"max_call\": " << s._maxWall << ", \"allocs\": " << s._allocs
+         << ", \"alloc_bytes\": " << s._allocBytes
+         << ", \"peak_heap_bytes\": " << s._peakHeap << " }"
+         << (i + 1 < PHASE_TOT ? "," : "") << endl;
+   }
+   os << "  ]," << endl << setprecision(2)
+      << "  \"max_resident_mb\": " << maxResident() << endl << "}" << endl;
+   os.flags(flags);
+   os.precision(prec);
+}
+
+/**********************************************/
+/*   Private member functions of CirProfiler  */
+/**********************************************/
+// charge the phase with what has been used since it was (re)started
+void
+CirProfiler::pause(Frame& f)
+{
+   const CirAllocCount& a = getAllocCount();
+   CirPhaseStat& s = _stats[f._phase];
+   double wall = wallTime() - f._wall;
+   s._wall += wall;
+   s._cpu += cpuSeconds() - f._cpu;
+   s._allocs += a._count - f._allocs;
+   s._allocBytes += a._bytes - f._allocBytes;
+   if (a._peak > s._peakHeap) s._peakHeap = a._peak;
+   f._callWall += wall;
+}
+
+void
+CirProfiler::resume(Frame& f)
+{
+   const CirAllocCount& a = getAllocCount();
+   resetAllocPeak();
+   f._allocs = a._count;
+   f._allocBytes = a._bytes;
+   f._cpu = cpuSeconds();
+   f._wall = wallTime();
+}
@@ -0,0 +1,112 @@
+/****************************************************************************
+  FileName     [ cirProfile.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define per-phase time and memory profiling ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_PROFILE_H
+#define CIR_PROFILE_H
+
+#include <vector>
+#include <iostream>
+#include <cstddef>
+
+using namespace std;
+
+enum CirPhase
+{
+   PHASE_PARSE   = 0,
+   PHASE_INIT    = 1,
+   PHASE_DFS     = 2,
+   PHASE_STRASH  = 3,
+   PHASE_OPT     = 4,
+   PHASE_SWEEP   = 5,
+   PHASE_REWRITE = 6,
+   PHASE_BALANCE = 7,
+   PHASE_SIM     = 8,
+   PHASE_FEC     = 9,
+   PHASE_CNF     = 10,
+   PHASE_SAT     = 11,
+
+   PHASE_TOT
+};
+
+// allocations by operator new, counted since the program started;
+// by thread; memory is charged to the thread that frees it
+struct CirAllocCount
+{
+   size_t     _count;
+   size_t     _bytes;
+   long long  _live;     // bytes not yet deleted
+   long long  _peak;     // of _live, since the last resetAllocPeak()
+};
+
+extern const CirAllocCount& getAllocCount();
+extern void resetAllocPeak();
+
+struct CirPhaseStat
+{
+   unsigned   _calls;
+   double     _wall;      // seconds
+   double     _cpu;       // seconds
+   double     _maxWall;   // of a single call
+   size_t     _allocs;
+   size_t     _allocBytes;
+   long long  _peakHeap;  // live bytes at the highest point
+};
+
+//------------------------------------------------------------------------
+//   Time and memory of the phases of the cir package
+//------------------------------------------------------------------------
+// A phase started inside another one (e.g. DFS inside strash) is charged
+// to itself only; the outer phase is paused meanwhile, so the times of
+// all the phases add up to the time spent in any of them.
+class CirProfiler
+{
+public:
+   CirProfiler() { reset(); }
+   ~CirProfiler() {}
+
+   void reset();
+   void start(CirPhase);
+   void stop();            // the phase started last
+   void merge(const CirProfiler&);
+
+   const CirPhaseStat& getStat(CirPhase p) const { return _stats[p]; }
+   static const char* getPhaseStr(CirPhase);
+
+   void report(ostream&) const;
+   void reportJson(ostream&) const;
+
+private:
+   struct Frame
+   {
+      CirPhase   _phase;
+      double     _wall;       // when the phase was (re)started
+      double     _cpu;
+      double     _callWall;   // of this call so far
+      size_t     _allocs;
+      size_t     _allocBytes;
+   };
+
+   CirPhaseStat     _stats[PHASE_TOT];
+   vector<Frame>    _stack;
+
+   void pause(Frame&);
+   void resume(Frame&);
+};
+
+// profile the enclosing scope as a phase
+class CirPhaseScope
+{
+public:
+   CirPhaseScope(CirProfiler& p, CirPhase ph): _profiler(p) { _profiler.start(ph); }
+   ~CirPhaseScope() { _profiler.stop(); }
+
+private:
+   CirProfiler&   _profiler;
+};
+
+#endif // CIR_PROFILE_H
@@ -0,0 +1,415 @@
+/****************************************************************************
+  FileName     [ cirRewrite.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define cir rewriting functions ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include "cirMgr.h"
+#include "cirGate.h"
+#include "cirRewrite.h"
+#include "util.h"
+
+using namespace std;
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+// truth tables of the 4 cut leaves
+static const unsigned short rwrVarTruth[RWR_CUT_SIZE] = {
+   0xAAAA, 0xCCCC, 0xF0F0, 0xFF00
+};
+
+// The library: a minimum size AND formula of every 4-input function,
+// built bottom-up by cost (#ANDs) with complemented edges for free.
+// For cost > 0, f = (rwrInv[f] ? !(g & h) : (g & h)), g = rwrIn0[f],
+// h = rwrIn1[f]. Functions beyond RWR_MAX_COST are left out (cost 0xFF).
+static unsigned char  rwrCost[1 << 16];
+static unsigned short rwrIn0[1 << 16];
+static unsigned short rwrIn1[1 << 16];
+static bool           rwrInv[1 << 16];
+static bool           rwrLibReady = false;
+
+static void
+buildRwrLib()
+{
+   if (rwrLibReady) return;
+
+   for (size_t f = 0; f < (1 << 16); f++) rwrCost[f] = 0xFF;
+   vector<vector<unsigned short> > level(1);
+   level[0].push_back(0x0000);
+   level[0].push_back(0xFFFF);
+   for (size_t i = 0; i < RWR_CUT_SIZE; i++) {
+      level[0].push_back(rwrVarTruth[i]);
+      level[0].push_back((unsigned short)~rwrVarTruth[i]);
+   }
+   for (size_t j = 0, n = level[0].size(); j < n; j++)
+      rwrCost[level[0][j]] = 0;
+
+   for (unsigned k = 1; k <= RWR_MAX_COST; k++) {
+      level.push_back(vector<unsigned short>());
+      for (unsigned i = 0; i <= (k - 1) / 2; i++) {
+         const vector<unsigned short>& la = level[i];
+         const vector<unsigned short>& lb = level[k - 1 - i];
+         for (size_t a = 0, na = la.size(); a < na; a++) {
+            for (size_t b = (i == k - 1 - i ? a : 0), nb = lb.size(); b < nb; b++) {
+               unsigned short f = la[a] & lb[b];
+               if (rwrCost[f] != 0xFF) continue;
+               unsigned short nf = ~f;
+               rwrCost[f] = rwrCost[nf] = k;
+               rwrIn0[f] = rwrIn0[nf] = la[a];
+               rwrIn1[f] = rwrIn1[nf] = lb[b];
+               rwrInv[f] = false;
+               rwrInv[nf] = true;
+               level[k].push_back(f);
+               level[k].push_back(nf);
+            }
+         }
+      }
+   }
+   rwrLibReady = true;
+}
+
+/**************************************************/
+/*   Public member functions about optimization   */
+/**************************************************/
+// Rewrite small cones of AIGs with smaller structures
+// _dfsList needs to be reconstructed afterwards
+void
+CirMgr::rewrite()
+{
+   CirPhaseScope prof(_profiler, PHASE_REWRITE);
+   unsigned before = _andGateCount;
+   CirRewriter rwr(this);
+   rwr.rewrite();
+   _dfsList_clean = false;
+   // the proof model has no variables for the new AIGs
+   delete _satSolver;
+   _satSolver = 0;
+
+   cout << "Rewriting: " << rwr.getReplacedCount() << " cones replaced, AIGs "
+        << before << " -> " << _andGateCount << endl;
+
+   #ifdef CHECK_INTEGRITY
+   checkIntegrity();
+   #endif  // CHECK_INTEGRITY
+}
+
+/****************************************/
+/*   class CirRewriter member functions   */
+/****************************************/
+CirRewriter::CirRewriter(CirMgr* mgr):
+   _mgr(mgr), _strash(getHashSize(mgr->_andGateCount * 5 / 3 + 1)),
+   _cutMgr(RWR_CUT_SIZE, RWR_MAX_CUTS), _nextId(0), _replaced(0)
+{
+   buildRwrLib();
+
+   unsigned last = 0;
+   for (GateMap::const_iterator it = _mgr->_gates.begin(); it != _mgr->_gates.end(); ++it) {
+      CirGate* g = it->second;
+      if (g->isAig()) _strash.insert(CirStrashKey(g), g);
+      for (unsigned id = last + 1; id < g->getID() && id <= _mgr->_maxNum; id++)
+         _freeIds.push_back(id);
+      last = g->getID();
+   }
+   for (unsigned id = last + 1; id <= _mgr->_maxNum; id++)
+      _freeIds.push_back(id);
+   // IDs above the POs, only if the free ones run out
+   _nextId = (last > _mgr->_maxNum ? last : _mgr->_maxNum) + 1;
+   reverse(_freeIds.begin(), _freeIds.end());
+}
+
+CirRewriter::~CirRewriter()
+{
+   for (size_t i = 0, n = _dead.size(); i < n; i++)
+      delete _dead[i];
+}
+
+void
+CirRewriter::rewrite()
+{
+   GateList l = _mgr->getDfsList();
+   unsigned maxId = _mgr->_maxNum;
+
+   for (size_t i = 0, n = l.size(); i < n; i++) {
+      CirGate* g = l[i];
+      if (!g->isAig() || !isAlive(g)) continue;
+
+      // the first cut is the trivial one
+      const CirCut* cuts = getCuts(g);
+      int bestGain = 0;
+      const CirCut* best = 0;
+      for (const CirCut* c = cuts->getNext(); c; c = c->getNext()) {
+         unsigned short truth = (unsigned short)c->getTruth();
+         if (rwrCost[truth] == 0xFF) continue;
+
+         CirGateV leaves[RWR_CUT_SIZE] = { 0 };
+         for (size_t j = 0; j < c->getSize(); j++)
+            leaves[j] = (CirGateV)c->getLeaf(j);
+         int mffc = derefCone(g, c);
+         CirGateV lit;
+         int added = buildTruth(truth, leaves, g, false, lit);
+         if (added < 0) continue;
+         if (mffc - added > bestGain) {
+            bestGain = mffc - added;
+            best = c;
+         }
+      }
+      if (!bestGain) continue;
+
+      CirGateV leaves[RWR_CUT_SIZE] = { 0 };
+      for (size_t j = 0; j < best->getSize(); j++)
+         leaves[j] = (CirGateV)best->getLeaf(j);
+      CirGateV lit;
+      _created.clear();
+      if (buildTruth((unsigned short)best->getTruth(), leaves, g, true, lit) < 0) {
+         // the MFFC gates reused made up the root again; undo
+         for (size_t j = _created.size(); j > 0; j--)
+            if (_created[j - 1]->_fanoutList.empty()) kill(_created[j - 1]);
+         continue;
+      }
+      replace(g, lit);
+      _replaced++;
+   }
+
+   for (GateMap::const_iterator it = _mgr->_gates.begin(); it != _mgr->_gates.end(); ++it)
+      if (it->second->isAig() && it->second->getID() > maxId)
+         maxId = it->second->getID();
+   _mgr->_maxNum = maxId;
+}
+
+// the cut lists are computed on demand and cached in _cutMgr.
+// A replacement may hang a gate on a strashed one that is processed (and
+// maybe deleted) later, so the cached lists with dead leaves are recomputed
+const CirCut*
+CirRewriter::getCuts(CirGate* g)
+{
+   if (_cutMgr.hasCuts(g)) {
+      const CirCut* cuts = _cutMgr.getCuts(g);
+      bool valid = true;
+      for (const CirCut* c = cuts->getNext(); c && valid; c = c->getNext())
+         for (size_t j = 0; j < c->getSize() && valid; j++)
+            valid = isAlive(c->getLeaf(j));
+      if (valid) return cuts;
+      _cutMgr.removeCuts(g);
+   }
+   if (g->isAig()) {
+      getCuts(g->getFanin(0));
+      getCuts(g->getFanin(1));
+   }
+   return _cutMgr.getCuts(g);
+}
+
+// size of the MFFC of root bounded by the cut;
+// the reference counts of the MFFC are left in _refs
+unsigned
+CirRewriter::derefCone(CirGate* root, const CirCut* cut)
+{
+   _refs.clear();
+   GateList stack(1, root);
+   unsigned count = 1;
+   while (!stack.empty()) {
+      CirGate* g = stack.back();
+      stack.pop_back();
+      for (size_t i = 0; i < g->_faninCount; i++) {
+         CirGate* f = g->getFanin(i);
+         if (!f->isAig() || find(cut->_leaves, cut->_leaves + cut->_size, f) != cut->_leaves + cut->_size)
+            continue;
+         size_t k = 0;
+         while (k < _refs.size() && _refs[k].first != f) k++;
+         if (k == _refs.size()) _refs.push_back(make_pair(f, f->_fanoutList.size()));
+         if (--_refs[k].second == 0) {
+            count++;
+            stack.push_back(f);
+         }
+      }
+   }
+   return count;
+}
+
+bool
+CirRewriter::inMffc(CirGate* g, CirGate* root) const
+{
+   if (g == root) return true;
+   for (size_t k = 0, n = _refs.size(); k < n; k++)
+      if (_refs[k].first == g) return _refs[k].second == 0;
+   return false;
+}
+
+// build (or only count if !create) the library formula of t over the
+// leaves; returns the #new AIGs, or -1 if the formula is not applicable.
+// `lit` is the result, or 0 if it is yet to be created
+int
+CirRewriter::buildTruth(unsigned short t, const CirGateV* leaves, CirGate* root,
+                        bool create, CirGateV& lit)
+{
+   if (rwrCost[t] == 0) {
+      if (t == 0x0000 || t == 0xFFFF) {
+         lit = (CirGateV)_mgr->getGate(0) | (t == 0xFFFF);
+         return 0;
+      }
+      for (size_t i = 0; i < RWR_CUT_SIZE; i++) {
+         if (t == rwrVarTruth[i] || t == (unsigned short)~rwrVarTruth[i]) {
+            if (!leaves[i]) return -1;
+            lit = leaves[i] ^ (t != rwrVarTruth[i]);
+            return 0;
+         }
+      }
+      assert(false);
+   }
+
+   CirGateV a, b;
+   int n0 = buildTruth(rwrIn0[t], leaves, root, create, a);
+   if (n0 < 0) return -1;
+   int n1 = buildTruth(rwrIn1[t], leaves, root, create, b);
+   if (n1 < 0) return -1;
+   if (!a || !b) {
+      lit = 0;
+      return n0 + n1 + 1;
+   }
+   int n = buildAnd(a, b, root, create, lit);
+   if (n < 0) return -1;
+   if (lit) lit ^= rwrInv[t];
+   return n0 + n1 + n;
+}
+
+// AND of two literals, by the rules of optimize() or from the strash table
+// if possible; the gates in the MFFC of root do not count when only counting
+int
+CirRewriter::buildAnd(CirGateV a, CirGateV b, CirGate* root, bool create, CirGateV& lit)
+{
+   CirGate* ga = (CirGate*)(a & ~(CirGateV)1);
+   CirGate* gb = (CirGate*)(b & ~(CirGateV)1);
+   bool ia = a & 1, ib = b & 1;
+
+   if (gb->_type == CONST_GATE) {
+      swap(ga, gb);
+      swap(ia, ib);
+   }
+   if ((ga->_type == CONST_GATE && !ia) || (ga == gb && ia != ib)) {
+      lit = (CirGateV)_mgr->getGate(0);
+      return 0;
+   }
+   if ((ga->_type == CONST_GATE && ia) || (ga == gb && ia == ib)) {
+      lit = (CirGateV)gb | ib;
+      return 0;
+   }
+
+   CirStrashKey key(ga, ia, gb, ib);
+   CirGate* t = 0;
+   if (_strash.check(key, t)) {
+      if (t == root) return -1;
+      if (create || !inMffc(t, root)) {
+         lit = (CirGateV)t;
+         return 0;
+      }
+   }
+   if (!create) {
+      lit = 0;
+      return 1;
+   }
+
+   unsigned id;
+   if (_freeIds.empty()) id = _nextId++;
+   else {
+      id = _freeIds.back();
+      _freeIds.pop_back();
+   }
+   CirGate* g = new AigGate(id, 0);
+   g->addFanin((CirGateV)ga | ia);
+   g->addFanin((CirGateV)gb | ib);
+   ga->addFanout((CirGateV)g | ia);
+   gb->addFanout((CirGateV)g | ib);
+   _mgr->_gates[id] = g;
+   _mgr->_andGateCount++;
+   _strash.forceInsert(key, g);
+   _created.push_back(g);
+   lit = (CirGateV)g;
+   return 1;
+}
+
+// move the fanouts of root to lit, then delete root and its MFFC.
+// A fanout is re-hashed by its new fanins; if it is then the same as a
+// strashed gate, it is replaced by that gate in turn. The gates replaced
+// are deleted at the end, so no gate taken for a replacement is gone
+void
+CirRewriter::replace(CirGate* root, CirGateV lit)
+{
+   assert((CirGate*)(lit & ~(CirGateV)1) != root);
+
+   vector<pair<CirGate*, CirGateV> > todo(1, make_pair(root, lit));
+   _strash.remove(CirStrashKey(root), root);
+   for (size_t k = 0; k < todo.size(); k++) {
+      CirGate* from = todo[k].first;
+      CirGate* to = (CirGate*)(todo[k].second & ~(CirGateV)1);
+      bool inv = todo[k].second & 1;
+
+      GateVList fanouts;
+      fanouts.swap(from->_fanoutList);
+      for (size_t i = 0, n = fanouts.size(); i < n; i++) {
+         CirGate* fo = (CirGate*)(fanouts[i] & ~(CirGateV)1);
+         if (fo->isAig()) _strash.remove(CirStrashKey(fo), fo);
+      }
+      for (size_t i = 0, n = fanouts.size(); i < n; i++) {
+         CirGate* fo = (CirGate*)(fanouts[i] & ~(CirGateV)1);
+         bool foInv = fanouts[i] & 1;
+         for (size_t j = 0; j < fo->_faninCount; j++) {
+            if (fo->getFanin(j) == from && fo->getInv(j) == foInv) {
+               fo->setFanin(j, (CirGateV)to | (foInv ^ inv));
+               break;
+            }
+         }
+         to->addFanout((CirGateV)fo | (foInv ^ inv));
+      }
+
+      CirGate::clearMark();
+      for (size_t i = 0, n = fanouts.size(); i < n; i++) {
+         CirGate* fo = (CirGate*)(fanouts[i] & ~(CirGateV)1);
+         if (!fo->isAig() || fo->isMarked()) continue;
+         fo->mark();
+         CirStrashKey key(fo);
+         CirGate* t = 0;
+         if (_strash.check(key, t)) todo.push_back(make_pair(fo, (CirGateV)t));
+         else _strash.forceInsert(key, fo);
+      }
+   }
+   for (size_t k = 0, n = todo.size(); k < n; k++)
+      if (isAlive(todo[k].first)) kill(todo[k].first);
+}
+
+// g must be an AIG without fanouts
+void
+CirRewriter::kill(CirGate* g)
+{
+   assert(g->isAig() && g->_fanoutList.empty());
+
+   _strash.remove(CirStrashKey(g), g);
+   for (size_t i = 0; i < g->_faninCount; i++)
+      g->getFanin(i)->eraseFanout(g);
+   for (size_t i = 0; i < g->_faninCount; i++) {
+      CirGate* f = g->getFanin(i);
+      if (f->isAig() && f->_fanoutList.empty() && isAlive(f))
+         kill(f);
+   }
+
+   _mgr->_gates.erase(g->getID());
+   _mgr->_andGateCount--;
+   _freeIds.push_back(g->getID());
+   _cutMgr.removeCuts(g);
+   _dead.push_back(g);
+}
+
+// deleted gates are kept in _dead, so the pointer is always valid
+bool
+CirRewriter::isAlive(CirGate* g) const
+{
+   return _mgr->getGate(g->getID()) == g;
+}
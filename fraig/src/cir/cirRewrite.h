@@ -0,0 +1,65 @@
+/****************************************************************************
+  FileName     [ cirRewrite.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define cut based AIG rewriting ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_REWRITE_H
+#define CIR_REWRITE_H
+
+#include <vector>
+#include "cirDef.h"
+#include "cirGate.h"
+#include "cirCut.h"
+#include "myHashMap.h"
+
+using namespace std;
+
+const unsigned RWR_CUT_SIZE  = 4;   // leaves of a cut; truth tables are 16-bit
+const unsigned RWR_MAX_CUTS  = 8;   // cuts kept per gate, besides the trivial one
+const unsigned RWR_MAX_COST  = 9;   // largest structure in the library
+
+//------------------------------------------------------------------------
+//   DAG-aware rewriting with 4-input cuts
+//------------------------------------------------------------------------
+// Every AIG in the DFS list is visited in topological order. For each of
+// its 4-feasible cuts, the function over the cut is looked up in a library
+// of minimum AND formulas of all 16-bit truth tables. The replacement is
+// counted against the MFFC of the gate (the gates that would go with it),
+// with the nodes that already exist in the strash table coming for free.
+// The best positive gain is applied.
+class CirRewriter
+{
+public:
+   CirRewriter(CirMgr* mgr);
+   ~CirRewriter();
+
+   void rewrite();
+
+   unsigned getReplacedCount() const { return _replaced; }
+
+private:
+   CirMgr*                                  _mgr;
+   HashMap<CirStrashKey, CirGate*>          _strash;
+   CirCutMgr                                _cutMgr;
+   vector<pair<CirGate*, size_t> >          _refs;    // virtual ref counts of the MFFC
+   GateList                                 _dead;    // deleted after rewriting
+   GateList                                 _created;
+   IdList                                   _freeIds;
+   unsigned                                 _nextId;
+   unsigned                                 _replaced;
+
+   const CirCut* getCuts(CirGate*);
+   unsigned derefCone(CirGate*, const CirCut*);
+   bool inMffc(CirGate*, CirGate*) const;
+
+   int buildTruth(unsigned short, const CirGateV*, CirGate*, bool, CirGateV&);
+   int buildAnd(CirGateV, CirGateV, CirGate*, bool, CirGateV&);
+   void replace(CirGate*, CirGateV);
+   void kill(CirGate*);
+   bool isAlive(CirGate*) const;
+};
+
+#endif // CIR_REWRITE_H
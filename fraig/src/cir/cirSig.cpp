@@ -0,0 +1,255 @@
+/****************************************************************************
+  FileName     [ cirSig.cpp ]
+  PackageName  [ cir ]
+  Synopsis     [ Define saving and loading of simulation signatures ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cstring>
+#include "cirMgr.h"
+#include "cirGate.h"
+#include "cirSim.h"
+#include "util.h"
+
+using namespace std;
+
+// The signature file, with 4-byte little endian numbers:
+//    "SIGB" <version> <SIM_BITS> <netlist hash, low and high words>
+//    <#PIs> <#blocks> { <#patterns> <word of each PI> }
+//    <#gates> { <gate ID> <signature> }
+//    <#FEC groups> { <#members> <with the constant> <member IDs> }
+// The blocks are all the PI words simulated so far; the signatures are
+// the values of the PIs and AIGs in the last one.
+
+/*******************************/
+/*   Global variable and enum  */
+/*******************************/
+
+/**************************************/
+/*   Static varaibles and functions   */
+/**************************************/
+static const char     sigMagic[4] = { 'S', 'I', 'G', 'B' };
+static const unsigned sigVersion  = 1;
+
+static void writeWord(ostream& os, unsigned w)
+{
+   char b[4];
+   for (unsigned k = 0; k < 4; k++) b[k] = (char)(w >> (8 * k));
+   os.write(b, 4);
+}
+
+static bool readWord(istream& is, unsigned& w)
+{
+   unsigned char b[4];
+   if (!is.read((char*)b, 4)) return false;
+   w = b[0] | (b[1] << 8) | (b[2] << 16) | ((unsigned)b[3] << 24);
+   return true;
+}
+
+// FNV-1a, by bytes
+static void hashWord(unsigned long long& h, unsigned w)
+{
+   for (unsigned k = 0; k < 4; k++) {
+      h ^= (w >> (8 * k)) & 0xFF;
+      h *= 1099511628211ULL;
+   }
+}
+
+static unsigned getLiteral(const CirGate* g, size_t i)
+{
+   return g->getFanin(i)->getID() * 2 + g->getInv(i);
+}
+
+/*************************************************/
+/*   Public member functions about signatures    */
+/*************************************************/
+bool
+CirMgr::saveSignatures(const string& fileName) const
+{
+   // Output Example:
+   // Signatures: P patterns, G FEC groups saved to "file"
+   ofstream ofs(fileName.c_str(), ios::out | ios::binary);
+   if (!ofs) {
+      cerr << "Error: cannot open file \"" << fileName << "\"!!" << endl;
+      return false;
+   }
+
+   ofs.write(sigMagic, sizeof(sigMagic));
+   writeWord(ofs, sigVersion);
+   writeWord(ofs, SIM_BITS);
+   unsigned long long h = getNetlistHash();
+   writeWord(ofs, (unsigned)h);
+   writeWord(ofs, (unsigned)(h >> 32));
+
+   size_t piSize = _piList.size();
+   writeWord(ofs, piSize);
+   writeWord(ofs, _simCounts.size());
+   unsigned patterns = 0;
+   for (size_t b = 0, n = _simCounts.size(); b < n; b++) {
+      writeWord(ofs, _simCounts[b]);
+      for (size_t i = 0; i < piSize; i++)
+         writeWord(ofs, _simPatterns[b * piSize + i]);
+      patterns += _simCounts[b];
+   }
+
+   GateList& l = getDfsList();
+   size_t sigs = 0;
+   for (size_t i = 0, n = l.size(); i < n; i++)
+      if (l[i]->isAig() || l[i]->_type == PI_GATE) sigs++;
+   writeWord(ofs, sigs);
+   for (size_t i = 0, n = l.size(); i < n; i++) {
+      if (!l[i]->isAig() && l[i]->_type != PI_GATE) continue;
+      writeWord(ofs, l[i]->getID());
+      writeWord(ofs, l[i]->getSimData());
+   }
+
+   size_t groups = (_fecGroupList ? _fecStore->getClassCount() : 0);
+   writeWord(ofs, groups);
+   for (size_t i = 0; i < groups; i++) {
+      const CirFecClass& c = _fecStore->getClass(i);
+      writeWord(ofs, c._size);
+      writeWord(ofs, c._const);
+      for (size_t j = 0; j < c._size; j++)
+         writeWord(ofs, _fecStore->getMember(c, j)->getID());
+   }
+
+   if (!ofs) {
+      cerr << "Error: cannot write file \"" << fileName << "\"!!" << endl;
+      return false;
+   }
+   cout << "Signatures: " << patterns << " patterns, " << groups
+        << " FEC groups saved to \"" << fileName << "\"" << endl;
+   return true;
+}
+
+// the FEC groups are then as if the patterns had been simulated
+bool
+CirMgr::loadSignatures(const string& fileName)
+{
+   ifstream ifs(fileName.c_str(), ios::in | ios::binary);
+   if (!ifs) {
+      cerr << "Error: cannot open file \"" << fileName << "\"!!" << endl;
+      return false;
+   }
+
+   char magic[4];
+   unsigned version, bits, hashLo, hashHi;
+   if (!ifs.read(magic, 4) || memcmp(magic, sigMagic, 4) != 0 ||
+       !readWord(ifs, version) || version != sigVersion ||
+       !readWord(ifs, bits) || bits != SIM_BITS ||
+       !readWord(ifs, hashLo) || !readWord(ifs, hashHi)) {
+      cerr << "Error: \"" << fileName << "\" is not a signature file!!" << endl;
+      return false;
+   }
+   unsigned long long h = getNetlistHash();
+   if (hashLo != (unsigned)h || hashHi != (unsigned)(h >> 32)) {
+      cerr << "Error: \"" << fileName << "\" is for another netlist!!" << endl;
+      return false;
+   }
+
+   // everything is read before the circuit is changed
+   size_t piSize = _piList.size();
+   unsigned nPi, nBlocks, nSigs, nGroups;
+   IdList counts;
+   vector<CirSimData> words;
+   vector<pair<CirGate*, CirSimData> > sigs;
+   FECGroupList groups;
+   bool ok = readWord(ifs, nPi) && nPi == piSize && readWord(ifs, nBlocks);
+   for (unsigned b = 0; ok && b < nBlocks; b++) {
+      unsigned c;
+      ok = readWord(ifs, c) && c <= SIM_BITS;
+      counts.push_back(c);
+      for (size_t i = 0; ok && i < piSize; i++) {
+         unsigned w;
+         ok = readWord(ifs, w);
+         words.push_back(w);
+      }
+   }
+   ok = ok && readWord(ifs, nSigs);
+   for (unsigned k = 0; ok && k < nSigs; k++) {
+      unsigned id, w;
+      ok = readWord(ifs, id) && readWord(ifs, w);
+      CirGate* g = (ok ? getGate(id) : 0);
+      ok = ok && g && (g->isAig() || g->_type == PI_GATE);
+      if (ok) sigs.push_back(make_pair(g, (CirSimData)w));
+   }
+   // the members are to be in the core
+   getAig();
+   ok = ok && readWord(ifs, nGroups);
+   for (unsigned k = 0; ok && k < nGroups; k++) {
+      unsigned size, withConst;
+      ok = readWord(ifs, size) && readWord(ifs, withConst);
+      GateList* gl = new GateList;
+      groups.push_back(gl);
+      if (ok && withConst) gl->push_back(_gates[0]);
+      for (unsigned j = 0; ok && j < size; j++) {
+         unsigned id;
+         ok = readWord(ifs, id);
+         CirGate* g = (ok ? getGate(id) : 0);
+         ok = ok && g && g->isAig() && getAigLit(id);
+         if (ok) gl->push_back(g);
+      }
+   }
+   if (!ok) {
+      cerr << "Error: \"" << fileName << "\" is broken!!" << endl;
+      for (size_t i = 0, n = groups.size(); i < n; i++) delete groups[i];
+      return false;
+   }
+
+   unsigned patterns = 0;
+   for (size_t b = 0; b < nBlocks; b++) {
+      recordPatterns(words.empty() ? 0 : &words[b * piSize], counts[b]);
+      patterns += counts[b];
+   }
+   for (size_t k = 0, n = sigs.size(); k < n; k++)
+      sigs[k].first->setSimData(sigs[k].second);
+   // not to be taken over by those of the last simulation
+   _simValues.clear();
+
+   if (!_fecStore) _fecStore = new CirFecStore;
+   _fecStore->assign(groups, _gates[0], _aigLits, _aigGates);
+   for (size_t i = 0, n = groups.size(); i < n; i++) delete groups[i];
+   if (!_fecGroupList) _fecGroupList = new FECGroupList;
+   collectFECGroups();
+
+   cout << "Signatures: " << patterns << " patterns, " << nGroups
+        << " FEC groups loaded from \"" << fileName << "\"" << endl;
+   return true;
+}
+
+/**************************************************/
+/*   Private member functions about signatures    */
+/**************************************************/
+// keep the PI words of a block for saveSignatures()
+void
+CirMgr::recordPatterns(const CirSimData* words, unsigned count)
+{
+   _simPatterns.insert(_simPatterns.end(), words, words + _piList.size());
+   _simCounts.push_back(count);
+}
+
+// of the structure only; the names do not matter
+unsigned long long
+CirMgr::getNetlistHash() const
+{
+   unsigned long long h = 14695981039346656037ULL;
+   hashWord(h, _maxNum);
+   hashWord(h, _piList.size());
+   hashWord(h, _poList.size());
+   for (size_t i = 0, n = _piList.size(); i < n; i++)
+      hashWord(h, _piList[i]->getID());
+   for (size_t i = 0, n = _poList.size(); i < n; i++)
+      hashWord(h, getLiteral(_poList[i], 0));
+   for (GateMap::const_iterator it = _gates.begin(); it != _gates.end(); ++it) {
+      const CirGate* g = it->second;
+      if (!g->isAig()) continue;
+      hashWord(h, g->getID());
+      hashWord(h, getLiteral(g, 0));
+      hashWord(h, getLiteral(g, 1));
+   }
+   return h;
+}
@@ -14,6 +14,7 @@
 #include <cmath>
 #include "cirMgr.h"
 #include "cirGate.h"
+#include "cirSim.h"
 #include "util.h"
 
 using namespace std;
@@ -28,194 +29,179 @@ using namespace std;
 /**************************************/
 /*   Static varaibles and functions   */
 /**************************************/
-// we often need the size ... and nothing else -w-
-static size_t _tmpDfsListSize = 0;
-
 
 static inline void fancyIO(bool x) {
    cout << (x ? "\033[01m\033[01m1\033[0m" : "\033[90m\033[02m0\033[0m");
 }
 
-static void printSimData(const CirSimData s) {
-   for (CirSimData i = SIM_HIGHEST_BIT; i > 0; i >>= 1) {
-      cout << (s & i ? 1 : 0); //fancyIO(s & i);
-   }
-}
-
-// clear FEC pointer if list is stuck at original one
-// because the list is to destoryed
-static void clearCurrentFECPtr(GateList* ls) {
-   for (size_t i = 0, n = ls->size(); i < n; i++) {
-      CirGate* g = ls->at(i);
-      if (g->_fecGroup == ls)
-         g->_fecGroup = 0;
-   }
-}
-static CirSimData randomSimData() {
+static CirSimData randomSimData(LocalRandomNumGen* gen) {
    // rnGen can only produce 31 bits random number
    // so we try to fill it by generating 16 bits repeatly
    CirSimData ret(0), b = SIM_HIGHEST_BIT >> 15;
    while (b) {
-      ret |= ((CirSimData)rnGen(1 << 16)) * b;
+      ret |= ((CirSimData)(gen ? (*gen)(1 << 16) : rnGen(1 << 16))) * b;
       b >>= 16;
    }
    return ret;
 }
 
-// check if their simulation is all the same
-// because creating lists is expensive
-static bool isFECGroupChanged(GateList* ls) {
-   CirSimData ref = ls->at(0)->getSimData();
-   for (size_t i = 1, n = ls->size(); i < n; i++) {
-      CirSimData comp = ls->at(i)->getSimData();
-      if (ref != comp && ref != ~comp)
-         return true;
-   }
-   return false;
+// parts of a class in the order their second members come
+static bool fecRunCompFN(const CirFecRun& a, const CirFecRun& b) {
+   return a._second < b._second;
 }
 
-// tmpPtr is a gate in disguise; create a new GateList for it
-static GateList* getRealFec(size_t tmp, CirGate* el) {
-   GateList* realFec = new GateList(2);
-   realFec->at(0) = (CirGate*)(tmp ^ 1);
-   realFec->at(1) = el;
-
-   // updating FEC pointer of the original gate
-   realFec->at(0)->_fecGroup = realFec;
-   return realFec;
-};
-
 /************************************************/
 /*   Public member functions about Simulation   */
 /************************************************/
+// Stop after a number of rounds without refinement, by default those
+// without a change in the #FEC groups; `effort` may instead count the
+// rounds without any change in the groups or in their total size, and
+// set a pattern or a CPU time budget
 void
-CirMgr::randomSim()
+CirMgr::randomSim(const CirSimEffort& effort)
 {
-   GateList& l = getDfsList();
-   _tmpDfsListSize = l.size();
+   size_t dfsSize = getDfsList().size();
 
    size_t piSize = _piList.size();
    CirSimData simi[piSize];
 
    unsigned simulatedCount = 0;
    unsigned previousFEC = 0;
+   size_t previousMembers = 0;
    unsigned failedCount = 0;
-   unsigned const maxFail = (unsigned)(3 + log(_tmpDfsListSize) * 20);
+   unsigned const maxFail = effort._idle ? effort._idle
+                          : (unsigned)(3 + log(dfsSize) * 20);
+
+   if (!effort._idle && _verbosity >= CIR_VERB_PROGRESS)
+      cout << "MAX_FAILS = " << maxFail << endl;
 
-   cout << "MAX_FAILS = " << maxFail << endl;
+   double start = cpuTime();
+   CirSimStats* stats = effort._stats ? newSimStats() : 0;
+   CirSimProgress progress(_verbosity);
 
    while (failedCount < maxFail) {
+      if (effort._patterns && simulatedCount >= effort._patterns) break;
+      if (effort._seconds && cpuTime() - start >= effort._seconds) break;
 
       // assigning input
       for (size_t i = 0; i < piSize; i++) {
-         simi[i] = randomSimData();
+         simi[i] = randomSimData(_rnGen);
          _piList[i]->setSimData(simi[i]);
       }
+      recordPatterns(simi, SIM_BITS);
 
+      double t0 = cpuTime();
       simulateCircuit();
+      double t1 = cpuTime();
       manipulateFECs();
+      double t2 = cpuTime();
 
-      size_t fecCnt = _fecGroupList->size();
-      if (previousFEC == fecCnt)
+      size_t fecCnt = _fecStore->getClassCount();
+      size_t members = (effort._idle || stats ? _fecStore->getMemberCount() : 0);
+      if (previousFEC == fecCnt && (!effort._idle || previousMembers == members))
          failedCount++;
+      else if (effort._idle)
+         failedCount = 0;
       previousFEC = fecCnt;
+      previousMembers = members;
+      if (stats) stats->addRound(SIM_BITS, t1 - t0, t2 - t1, fecCnt, members);
 
       // generate log
       outputSimResult(simi);
       simulatedCount += SIM_BITS;
 
-      cout << "\rTotal #FEC Group: " << fecCnt
-           << " | Simulated = " << simulatedCount
-           << " | CURR_FAILS = " << failedCount  << flush;
+      if (progress.show())
+         cout << "\rTotal #FEC Group: " << fecCnt
+              << " | Simulated = " << simulatedCount
+              << " | CURR_FAILS = " << failedCount  << flush;
    }
 
-   cout << endl << simulatedCount << " patterns simulated." << endl;
+   collectFECGroups();
+   progress.end();
+   if (!isSilent())
+      cout << simulatedCount << " patterns simulated." << endl;
+   if (stats) {
+      stats->report(cpuTime() - start);
+      delete stats;
+   }
 }
 
 void
-CirMgr::fileSim(ifstream& patternFile)
+CirMgr::fileSim(CirPatternReader& reader, bool doStats)
 {
    size_t piSize = _piList.size();
-   unsigned readCount = 0, simulatedCount = 0, usedBits = 0;
-   bool stopRead = false;
-   string strBuf;
-   CirSimData bit = SIM_HIGHEST_BIT;
+   unsigned simulatedCount = 0;
    CirSimData inputBuf[piSize];
 
+   double start = cpuTime();
+   CirSimStats* stats = doStats ? newSimStats() : 0;
+   CirSimProgress progress(_verbosity);
+
    while (true) {
-      patternFile >> strBuf;
-      size_t len = strBuf.length();
-      if (len > 0 && len != piSize) {
-         cerr << "Error: Pattern(" << strBuf << ") length(" << len
-            << ") does not match the number of inputs(" << piSize
-            << ") in a circuit!!" << endl;
-         break;
-      }
+      // a block with an error is not simulated
+      int readCount = reader.read(inputBuf, piSize);
+      if (readCount <= 0) break;
 
-      if (!patternFile.fail()) {
-         for (size_t i = 0; i < piSize; i++) {
-            if (strBuf[i] == '0') {
-               inputBuf[i] &= ~bit;
-            } else if (strBuf[i] == '1') {
-               inputBuf[i] |= bit;
-            } else {
-               cerr << "Error: Pattern(" << strBuf << ") contains a non-0/1 character('"
-                    << strBuf[i] << "')." << endl;
-               stopRead = true;
-               break;
-            }
-         }
-         if (stopRead) break;
-         bit >>= 1;
-         readCount++;
-      } else {
-         // clear remaining bits to 0
-         for (size_t i = 0; i < piSize; i++)
-            inputBuf[i] &= ~((bit << 1) - 1);
-         // count remaining bits; clear it eventually
-         while (bit <<= 1)
-            usedBits++;
-         // but if no bits are used, break directly
-         if (!usedBits) break;
-      }
+      for (size_t i = 0; i < piSize; i++)
+         _piList[i]->setSimData(inputBuf[i]);
+      recordPatterns(inputBuf, readCount);
 
-      if (!bit) {
-         for (size_t i = 0; i < piSize; i++)
-            _piList[i]->setSimData(inputBuf[i]);
+      double t0 = cpuTime();
+      simulateCircuit();
+      double t1 = cpuTime();
+      manipulateFECs();
+      double t2 = cpuTime();
 
-         simulateCircuit();
-         manipulateFECs();
+      size_t n = _fecStore->getClassCount();
+      if (stats)
+         stats->addRound(readCount, t1 - t0, t2 - t1, n, _fecStore->getMemberCount());
 
-         // `usedBits == 0` means unlimited
-         outputSimResult(inputBuf, usedBits);
+      // 0 means all the bits
+      outputSimResult(inputBuf, readCount < (int)SIM_BITS ? readCount : 0);
 
-         simulatedCount += readCount;
+      simulatedCount += readCount;
 
-         size_t n = _fecGroupList->size();
+      if (progress.show())
          cout << "\rTotal #FEC Group: " << n
               << " | simulated = " << simulatedCount << flush;
 
-         readCount = 0;
-
-         if (patternFile.fail())
-            break;
-
-         bit = SIM_HIGHEST_BIT;
-      }
+      if (readCount < (int)SIM_BITS) break;
    }
 
-   cout << endl << simulatedCount << " patterns simulated." << endl;
+   collectFECGroups();
+   progress.end();
+   cout << simulatedCount << " patterns simulated." << endl;
+   if (stats) {
+      stats->report(cpuTime() - start);
+      delete stats;
+   }
 }
 
 /*************************************************/
 /*   Private member functions about Simulation   */
 /*************************************************/
+// on the core; the gates only take the values by updateSimData()
 void CirMgr::simulateCircuit() {
-   GateList& l = getDfsList();
-   _tmpDfsListSize = l.size();
+   const CirAig& aig = getAig();
+   CirPhaseScope prof(_profiler, PHASE_SIM);
+
+   unsigned nIn = aig.getInputCount();
+   _simValues.resize(aig.getNodeCount());
+   for (unsigned n = 1; n <= nIn; n++)
+      _simValues[n] = _aigGates[n]->getSimData();
+   aig.simulate(_simValues);
+}
 
-   for (size_t i = 0; i < _tmpDfsListSize; i++)
-      l[i]->simulate();
+// the values of the last simulation to the gates, for the reporting,
+// the guides and fraig
+void CirMgr::updateSimData() {
+   CirPhaseScope prof(_profiler, PHASE_SIM);
+   const CirAig& aig = getAig();
+   if (_simValues.size() != aig.getNodeCount()) return;
+   for (unsigned n = aig.getInputCount() + 1, e = aig.getNodeCount(); n < e; n++)
+      _aigGates[n]->setSimData(_simValues[n]);
+   for (size_t i = 0, n = _poList.size(); i < n; i++)
+      _poList[i]->setSimData(CirAig::getValue(_simValues, aig.getOutput(i)));
 }
 
 void CirMgr::initFECGroup() {
@@ -223,131 +209,50 @@ void CirMgr::initFECGroup() {
    delete _fecGroupList;
    _fecGroupList = new FECGroupList();
 
-   GateList* ls = new GateList();
-   _fecGroupList->push_back(ls);
-   ls->reserve(_tmpDfsListSize);
-
-   // must in ascending order
-   for (GateMap::const_iterator it = _gates.begin(); it != _gates.end(); ++it) {
-      CirGate* gate = (*it).second;
-      if (!gate->isMarked() || !gate->isAig()) continue;
-      ls->push_back(gate);
-      gate->_fecGroup = ls;
-   }
+   // must in ascending order of the gate IDs
+   const CirAig& aig = getAig();
+   vector<pair<unsigned, unsigned> > ids;
+   ids.reserve(aig.getAndCount());
+   for (unsigned n = aig.getInputCount() + 1, e = aig.getNodeCount(); n < e; n++)
+      ids.push_back(make_pair(_aigGates[n]->getID(), n));
+   sort(ids.begin(), ids.end());
+
+   IdList nodes(ids.size());
+   for (size_t i = 0, n = ids.size(); i < n; i++)
+      nodes[i] = ids[i].second;
+   if (!_fecStore) _fecStore = new CirFecStore;
+   _fecStore->init(nodes, _aigGates);
 }
 
-// FIXME
-// The verdict of each FEC group can be collected:
-//   1) U - unchanged: the patterns are all the same
-//   2) D - diverge:   some new FEC groups formed
-//   3) S - shrink:    no new FEC groups formed
-//
-// return if this operation is considered as "successful"
-// used to control the effort in random-simulations
+// one round of refinement by the current simulation values;
+// the GateLists are only made by collectFECGroups() for the users
 void CirMgr::manipulateFECs() {
+   CirPhaseScope prof(_profiler, PHASE_FEC);
    if (!_fecGroupList) initFECGroup();
+   _fecStore->refine(_simValues);
+}
 
-   HashMap<CirPatternKey, GateList*> patHash(getHashSize(10 + _tmpDfsListSize / 100));
-
-   // pre-process "stuck-at-const" gates; constant gate always have a 0 key
-   CirGate* constGate = _gates[0];
-   if (!constGate->_fecGroup) {
-      // must use revision 0 to only process before the first group
-      CirPatternKey kConst(0, 0);
-      patHash.insert(kConst, (GateList*)((size_t)constGate | 1));
-   }
-
-   unsigned revNum = 0;
-
-   for (size_t i = 0, n = _fecGroupList->size(); i < n; i++) {
-      #ifdef VERBOSE
-      cout << "====== FEC pairs #" << i << " ======" << endl;
-      #endif  // VERBOSE
-
-      GateList* currList = _fecGroupList->at(i);
-      GateList* replacingList = 0;
-
-      if (constGate->_fecGroup && !isFECGroupChanged(currList)) continue;
-
-      for (size_t j = 0, m = currList->size(); j < m; j++) {
-         CirGate* g = currList->at(j);
-         CirSimData result = g->getSimData();
-         // reusing hash map... different revisions are not confused
-         CirPatternKey k(result, revNum);
-
-         #ifdef VERBOSE
-         cout << "  Gate #" << setw(4) << j << "(" << setw(4) << g->getID() << "): ";
-         printSimData(result);
-         cout << "... ";
-         #endif  // VERBOSE
-
-         GateList* tmpPtr;
-         if (patHash.check(k, tmpPtr)) {
-            if ((size_t)tmpPtr & 1) {
-               tmpPtr = getRealFec((size_t) tmpPtr, g);
-               patHash.replaceInsert(k, tmpPtr);
-
-               #ifdef VERBOSE
-               cout << "matched \033[1;34m" << tmpPtr->at(0)->getID() << "\033[1;0m to pair";
-               if (!replacingList)
-                  cout << " \033[1;01m(replacing)\033[0m";
-               cout << endl;
-               #endif  // VERBOSE
-
-               if (replacingList)
-                  _fecGroupList->push_back(tmpPtr);
-               else
-                  replacingList = tmpPtr;
-            } else {
-               // tmpPtr is really a GateList
-               tmpPtr->push_back(g);
-
-               #ifdef VERBOSE
-               cout << "matched \033[1;32m" << tmpPtr->at(0)->getID() << "\033[1;0m again" << endl;
-               #endif  // VERBOSE
-            }
-
-            // update FEC group
-            g->_fecGroup = tmpPtr;
-         } else {
-            #ifdef VERBOSE
-            cout << "\033[1;02mno\033[1;0m" << endl;
-            #endif  // VERBOSE
-            patHash.forceInsert(k, (GateList*)((size_t)g | 1));
-         }
-      }
+// statistics starting from the current FEC groups,
+// or from the single one to be made by initFECGroup()
+CirSimStats* CirMgr::newSimStats() const {
+   if (_fecGroupList)
+      return new CirSimStats(_fecStore->getClassCount(), _fecStore->getMemberCount());
+   GateList& l = getDfsList();
+   size_t members = 0;
+   for (size_t i = 0, n = l.size(); i < n; i++)
+      if (l[i]->isAig()) members++;
+   return new CirSimStats(1, members);
+}
 
-      // update rev num; note `i` may be changed, so it cannot be the revision!!!
-      // (debugged for > 1e6 sec and realized)
-      revNum++;
-
-      // recycle singletons
-      clearCurrentFECPtr(currList);
-
-      // discard old FEC list
-      if (replacingList) {
-         #ifdef VERBOSE
-         cout << "Result: use FEC " << replacingList->at(0)->getID() << " to replace" << endl;
-         #endif  // VERBOSE
-
-         _fecGroupList->at(i) = replacingList;
-      } else {
-         #ifdef VERBOSE
-         cout << "Result: \033[1;33mshrink...\033[1;0m move #" << (n-1) << "("
-              << _fecGroupList->back()->at(0)->getID() << ") here" << endl;
-         #endif  // VERBOSE
-
-         // if no FEC is discovered,
-         // move the last one item here to prevent O(n) erase
-         _fecGroupList->at(i) = _fecGroupList->at(n - 1);
-         _fecGroupList->at(n - 1) = _fecGroupList->back();
-         _fecGroupList->pop_back();
-
-         // update total; keep the index intact
-         n--; i--;
-      }
-      delete currList;
-   }
+// turn the classes into _fecGroupList and the _fecGroup of the members
+void CirMgr::collectFECGroups() {
+   if (!_fecGroupList) return;
+   updateSimData();
+   CirPhaseScope prof(_profiler, PHASE_FEC);
+   for (size_t i = 0, n = _fecGroupList->size(); i < n; i++)
+      delete _fecGroupList->at(i);
+   _fecGroupList->clear();
+   _fecStore->getGroups(*_fecGroupList, _gates[0]);
 }
 
 // output the result to file if specified in `-f` option.
@@ -358,27 +263,260 @@ void CirMgr::outputSimResult(CirSimData input[], unsigned len) {
    if (!_simLog) return;
    #endif  // VERBOSE
 
-   ostream& simout = _simLog ? *_simLog : cout;
-   unsigned cnt = 0;
    size_t poSize = _poList.size();
    CirSimData output[poSize];
 
    // fetching simulating result
-   for (size_t i = 0; i < poSize; i++) {
-      _poList[i]->simulate();
-      output[i] = _poList[i]->getSimData();
+   const CirAig& aig = getAig();
+   for (size_t i = 0; i < poSize; i++)
+      output[i] = CirAig::getValue(_simValues, aig.getOutput(i));
+
+   if (_simLog) {
+      _simLog->write(input, output, len ? len : SIM_BITS);
+      return;
+   }
+   CirSimLog screen(cout, _piList.size(), poSize);
+   screen.write(input, output, len ? len : SIM_BITS);
+   cout << flush;
+}
+
+/*****************************************/
+/*   class CirFecStore member functions  */
+/*****************************************/
+void
+CirFecStore::init(const IdList& nodes, const GateList& gates)
+{
+   _perm = nodes;
+   _gates = &gates;
+   _classes.clear();
+   _classes.reserve(nodes.size() / 2 + 1);
+   CirFecClass c = { 0, (unsigned)nodes.size(), false };
+   _classes.push_back(c);
+   _constGrouped = false;
+
+   _keys.resize(nodes.size() + 1);
+   _runs.clear();
+   _runs.reserve(nodes.size() / 2 + 1);
+   _buf.resize(nodes.size());
+}
+
+// the classes as given, e.g. saved by getGroups(); `lits` are those of
+// the gates in the core, by gate ID
+void
+CirFecStore::assign(const FECGroupList& l, CirGate* constGate,
+                    const IdList& lits, const GateList& gates)
+{
+   _perm.clear();
+   _gates = &gates;
+   _classes.clear();
+   _constGrouped = false;
+   for (size_t i = 0, n = l.size(); i < n; i++) {
+      const GateList& gl = *l[i];
+      CirFecClass c = { (unsigned)_perm.size(), 0, false };
+      for (size_t j = 0, m = gl.size(); j < m; j++) {
+         if (gl[j] == constGate) c._const = _constGrouped = true;
+         else _perm.push_back(lits[gl[j]->getID()] >> 1);
+      }
+      c._size = _perm.size() - c._begin;
+      _classes.push_back(c);
+   }
+
+   _keys.resize(_perm.size() + 1);
+   _runs.clear();
+   _runs.reserve(_perm.size() / 2 + 1);
+   _buf.resize(_perm.size());
+}
+
+// by the values of the nodes
+void
+CirFecStore::refine(const vector<CirSimData>& values)
+{
+   _values = &values[0];
+
+   // the constant is only tried with the first class refined in the round
+   bool joinConst = !_constGrouped;
+   bool first = true;
+
+   for (size_t i = 0, n = _classes.size(); i < n; i++) {
+      if (_constGrouped && !isChanged(_classes[i])) continue;
+
+      bool withConst = joinConst && first;
+      first = false;
+      if (split(i, withConst)) continue;
+
+      // nothing left; the classes appended in this round stay behind
+      _classes[i] = _classes[n - 1];
+      _classes[n - 1] = _classes.back();
+      _classes.pop_back();
+      n--; i--;
    }
+}
 
-   for (CirSimData b = SIM_HIGHEST_BIT; b > 0; b >>= 1) {
-      for (size_t i = 0, n = _piList.size(); i < n; i++)
-         simout << (bool)(input[i] & b);
-      simout << " ";
+size_t
+CirFecStore::getMemberCount() const
+{
+   size_t cnt = 0;
+   for (size_t i = 0, n = _classes.size(); i < n; i++)
+      cnt += _classes[i]._size + _classes[i]._const;
+   return cnt;
+}
 
-      for (size_t i = 0; i < poSize; i++)
-         simout << (bool)(output[i] & b);
-      simout << endl;
+void
+CirFecStore::getGroups(FECGroupList& l, CirGate* constGate) const
+{
+   for (size_t i = 0, n = _perm.size(); i < n; i++)
+      (*_gates)[_perm[i]]->_fecGroup = 0;
+   constGate->_fecGroup = 0;
+
+   l.reserve(_classes.size());
+   for (size_t i = 0, n = _classes.size(); i < n; i++) {
+      const CirFecClass& c = _classes[i];
+      GateList* gl = new GateList;
+      gl->reserve(c._size + c._const);
+      if (c._const) gl->push_back(constGate);
+      for (unsigned k = 0; k < c._size; k++)
+         gl->push_back((*_gates)[_perm[c._begin + k]]);
+      for (size_t j = 0, m = gl->size(); j < m; j++)
+         gl->at(j)->_fecGroup = gl;
+      l.push_back(gl);
+   }
+}
+
+// if the members do not all have the same value (or its complement)
+bool
+CirFecStore::isChanged(const CirFecClass& c) const
+{
+   if (!c._size) return true;
+   CirSimData ref = (c._const ? 0 : _values[_perm[c._begin]]);
+   for (size_t k = 0; k < c._size; k++) {
+      CirSimData s = _values[_perm[c._begin + k]];
+      if (s != ref && s != ~ref) return true;
+   }
+   return false;
+}
 
-      cnt++;
-      if (len && cnt == len) break;
+// split the i-th class; false if every member is left alone
+bool
+CirFecStore::split(size_t i, bool withConst)
+{
+   const CirFecClass c = _classes[i];
+   bool hasConst = c._const || withConst;
+
+   // position 0 is for the constant, whose value is always 0;
+   // a value and its complement share the key with the LSB cleared
+   unsigned m = 0;
+   if (hasConst) _keys[m++] = make_pair((CirSimData)0, 0u);
+   for (unsigned k = 0; k < c._size; k++) {
+      CirSimData s = _values[_perm[c._begin + k]];
+      _keys[m++] = make_pair((s & 1) ? ~s : s, k + 1);
+   }
+   sort(_keys.begin(), _keys.begin() + m);
+
+   _runs.clear();
+   for (unsigned b = 0, e; b < m; b = e) {
+      for (e = b + 1; e < m && _keys[e].first == _keys[b].first; e++) ;
+      if (e - b < 2) continue;
+      CirFecRun r = { _keys[b + 1].second, b, e - b };
+      _runs.push_back(r);
+   }
+   sort(_runs.begin(), _runs.end(), fecRunCompFN);
+
+   // the parts first, then the members left alone
+   unsigned w = 0;
+   bool constGrouped = false;
+   for (size_t t = 0, nr = _runs.size(); t < nr; t++) {
+      CirFecClass part = { c._begin + w, 0, false };
+      for (unsigned j = _runs[t]._begin, e = j + _runs[t]._size; j < e; j++) {
+         if (_keys[j].second) _buf[w++] = _perm[c._begin + _keys[j].second - 1];
+         else part._const = constGrouped = true;
+      }
+      part._size = c._begin + w - part._begin;
+      if (t) _classes.push_back(part);
+      else _classes[i] = part;
+   }
+   for (unsigned b = 0, e; b < m; b = e) {
+      for (e = b + 1; e < m && _keys[e].first == _keys[b].first; e++) ;
+      if (e - b == 1 && _keys[b].second)
+         _buf[w++] = _perm[c._begin + _keys[b].second - 1];
    }
+   assert(w == c._size);
+   copy(_buf.begin(), _buf.begin() + w, _perm.begin() + c._begin);
+
+   if (hasConst) _constGrouped = constGrouped;
+   return !_runs.empty();
+}
+
+/*****************************************/
+/*   class CirSimStats member functions  */
+/*****************************************/
+CirSimStats::CirSimStats(size_t classes, size_t members):
+   _rounds(0), _refining(0), _lastRefining(0), _patterns(0),
+   _simTime(0), _fecTime(0)
+{
+   _classes[0] = _classes[1] = classes;
+   _members[0] = _members[1] = members;
+}
+
+void
+CirSimStats::addRound(unsigned patterns, double simTime, double fecTime,
+                      size_t classes, size_t members)
+{
+   _rounds++;
+   if (classes != _classes[1] || members != _members[1]) {
+      _refining++;
+      _lastRefining = _rounds;
+   }
+   _patterns += patterns;
+   _simTime += simTime;
+   _fecTime += fecTime;
+   _classes[1] = classes;
+   _members[1] = members;
+}
+
+void
+CirSimStats::report(double totalTime) const
+{
+   double rounds = (_rounds ? _rounds : 1);
+   cout << "Simulation statistics" << endl
+        << "  Rounds    : " << _rounds << " (" << _refining
+        << " refining, the last one #" << _lastRefining << ")" << endl
+        << "  Patterns  : " << _patterns << " (" << fixed << setprecision(0)
+        << (totalTime > 0 ? _patterns / totalTime : 0.0) << " per second)" << endl
+        << "  FEC groups: " << _classes[0] << " -> " << _classes[1]
+        << ", members " << _members[0] << " -> " << _members[1] << endl
+        << "  Per round : " << setprecision(2)
+        << ((double)_classes[1] - _classes[0]) / rounds << " groups, "
+        << ((double)_members[0] - _members[1]) / rounds << " members refined" << endl
+        << "  Time      : " << setprecision(4) << totalTime << " s = "
+        << _simTime << " simulation + " << _fecTime << " FEC + "
+        << std::max(totalTime - _simTime - _fecTime, 0.0) << " others" << endl;
+   cout.unsetf(ios::fixed);
+   cout << setprecision(6);
+}
+
+/********************************************/
+/*   class CirSimProgress member functions  */
+/********************************************/
+CirSimProgress::CirSimProgress(CirVerbosity v):
+   _verbosity(v), _last(cpuTime()), _shown(false)
+{
+}
+
+bool
+CirSimProgress::show()
+{
+   if (_verbosity < CIR_VERB_PROGRESS) return false;
+   if (_verbosity == CIR_VERB_PROGRESS) {
+      double now = cpuTime();
+      if (now - _last < 1) return false;
+      _last = now;
+   }
+   _shown = true;
+   return true;
+}
+
+void
+CirSimProgress::end() const
+{
+   if (_shown || _verbosity >= CIR_VERB_ITEM) cout << endl;
 }
@@ -0,0 +1,125 @@
+/****************************************************************************
+  FileName     [ cirSim.h ]
+  PackageName  [ cir ]
+  Synopsis     [ Define the FEC classes refined by simulation ]
+  Author       [ Chung-Yang (Ric) Huang ]
+  Copyright    [ Copyleft(c) 2008-present LaDs(III), GIEE, NTU, Taiwan ]
+****************************************************************************/
+
+#ifndef CIR_SIM_H
+#define CIR_SIM_H
+
+#include <vector>
+#include "cirDef.h"
+
+using namespace std;
+
+struct CirFecClass
+{
+   unsigned  _begin;
+   unsigned  _size;     // in the permutation array, without the constant
+   bool      _const;
+};
+
+// a part of a class being split
+struct CirFecRun
+{
+   unsigned  _second;   // position of the 2nd member, for the order
+   unsigned  _begin;    // in the (signature, position) pairs
+   unsigned  _size;
+};
+
+//------------------------------------------------------------------------
+//   FEC classes over a single permutation array
+//------------------------------------------------------------------------
+// Every class is a range of _perm, the nodes in the core of CirMgr; a
+// refinement splits the range in place by sorting (signature, position)
+// pairs, so the member order is kept and nothing is allocated once init()
+// has reserved the scratch arrays. The gates are only for the users.
+// The constant gate is never in _perm; a class only carries a flag for it,
+// and it is then the first member.
+//
+// The classes come out in the same order as the GateList version did:
+// the part whose second member comes first takes the place of the old
+// class, the other parts are appended, and a class falling apart entirely
+// is replaced by the last of the classes not yet refined in the round.
+class CirFecStore
+{
+public:
+   CirFecStore(): _gates(0), _values(0), _constGrouped(false) {}
+
+   void init(const IdList& nodes, const GateList& gates);
+   void assign(const FECGroupList&, CirGate* constGate,
+               const IdList& lits, const GateList& gates);
+   void refine(const vector<CirSimData>& values);
+
+   size_t getClassCount() const { return _classes.size(); }
+   size_t getMemberCount() const;
+   const CirFecClass& getClass(size_t i) const { return _classes[i]; }
+   CirGate* getMember(const CirFecClass& c, size_t j) const {
+      return (*_gates)[_perm[c._begin + j]];
+   }
+   void getGroups(FECGroupList&, CirGate* constGate) const;
+
+private:
+   IdList                              _perm;
+   const GateList*                     _gates;    // by node
+   const CirSimData*                   _values;   // by node, in refine()
+   vector<CirFecClass>                 _classes;
+   bool                                _constGrouped;
+
+   // scratch, reserved by init()
+   vector<pair<CirSimData, unsigned> > _keys;   // signature, position
+   vector<CirFecRun>                   _runs;
+   IdList                              _buf;
+
+   bool isChanged(const CirFecClass&) const;
+   bool split(size_t i, bool withConst);
+};
+
+//------------------------------------------------------------------------
+//   Statistics of a CIRSIMulate command
+//------------------------------------------------------------------------
+class CirSimStats
+{
+public:
+   CirSimStats(size_t classes, size_t members);
+
+   void addRound(unsigned patterns, double simTime, double fecTime,
+                 size_t classes, size_t members);
+   void report(double totalTime) const;
+
+private:
+   unsigned    _rounds;
+   unsigned    _refining;      // rounds with any refinement
+   unsigned    _lastRefining;
+   unsigned    _patterns;
+   double      _simTime;
+   double      _fecTime;
+   size_t      _classes[2];    // first, now
+   size_t      _members[2];
+};
+
+//------------------------------------------------------------------------
+//   The "Total #FEC Group" line of a simulation run, by the verbosity
+//------------------------------------------------------------------------
+// Every block is shown at CIR_VERB_ITEM, at most one a second (of CPU
+// time, from the start of the run) at CIR_VERB_PROGRESS, and none at
+// CIR_VERB_SUMMARY
+class CirSimProgress
+{
+public:
+   CirSimProgress(CirVerbosity v);
+
+   bool show();
+   bool wasShown() const { return _shown; }
+   // ends the line, if any, before the summary
+   void end() const;
+
+private:
+   CirVerbosity   _verbosity;
+   double         _last;
+   bool           _shown;
+};
+
+#endif // CIR_SIM_H
@@ -1,4 +1,7 @@
-Proof.o: Proof.cpp Proof.h SolverTypes.h Global.h File.h Sort.h
+Drat.o: Drat.cpp Drat.h SolverTypes.h Global.h
 File.o: File.cpp File.h Global.h
+Proof.o: Proof.cpp Proof.h SolverTypes.h Global.h File.h Sort.h
+SimpSolver.o: SimpSolver.cpp SimpSolver.h Solver.h SolverTypes.h Global.h \
+ VarOrder.h Heap.h Proof.h File.h Drat.h Sort.h
 Solver.o: Solver.cpp Solver.h SolverTypes.h Global.h VarOrder.h Heap.h \
- Proof.h File.h Sort.h
+ Proof.h File.h Drat.h Sort.h
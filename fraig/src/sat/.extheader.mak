@@ -1,10 +1,13 @@
-sat.d: ../../include/sat.h ../../include/Solver.h ../../include/SolverTypes.h ../../include/VarOrder.h ../../include/Proof.h ../../include/Global.h ../../include/File.h ../../include/Heap.h ../../include/Sort.h 
+sat.d: ../../include/sat.h ../../include/Solver.h ../../include/SimpSolver.h ../../include/SolverTypes.h ../../include/VarOrder.h ../../include/Proof.h ../../include/Drat.h ../../include/Global.h ../../include/File.h ../../include/Heap.h ../../include/Sort.h 
 ../../include/sat.h: sat.h
 	@rm -f ../../include/sat.h
 	@ln -fs ../src/sat/sat.h ../../include/sat.h
 ../../include/Solver.h: Solver.h
 	@rm -f ../../include/Solver.h
 	@ln -fs ../src/sat/Solver.h ../../include/Solver.h
+../../include/SimpSolver.h: SimpSolver.h
+	@rm -f ../../include/SimpSolver.h
+	@ln -fs ../src/sat/SimpSolver.h ../../include/SimpSolver.h
 ../../include/SolverTypes.h: SolverTypes.h
 	@rm -f ../../include/SolverTypes.h
 	@ln -fs ../src/sat/SolverTypes.h ../../include/SolverTypes.h
@@ -14,6 +17,9 @@ sat.d: ../../include/sat.h ../../include/Solver.h ../../include/SolverTypes.h ..
 ../../include/Proof.h: Proof.h
 	@rm -f ../../include/Proof.h
 	@ln -fs ../src/sat/Proof.h ../../include/Proof.h
+../../include/Drat.h: Drat.h
+	@rm -f ../../include/Drat.h
+	@ln -fs ../src/sat/Drat.h ../../include/Drat.h
 ../../include/Global.h: Global.h
 	@rm -f ../../include/Global.h
 	@ln -fs ../src/sat/Global.h ../../include/Global.h
@@ -0,0 +1,56 @@
+/***************************************************************************************[Drat.cpp]
+MiniSat -- Copyright (c) 2003-2005, Niklas Een, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "Drat.h"
+#include <unistd.h>
+#include <fcntl.h>
+
+
+DratWriter::DratWriter(void) : fd(-1), bytes(0), added(0), deleted(0) { }
+
+
+DratWriter::DratWriter(cchar* filename) : bytes(0), added(0), deleted(0)
+{
+    fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) fd = -2;
+    buf.capacity(Drat_BufSize);
+}
+
+
+DratWriter::~DratWriter(void)
+{
+    if (fd >= 0){
+        flush();
+        ::close(fd); }
+}
+
+
+// Writes out the buffer (file mode only; a no-op in memory mode).
+//
+void DratWriter::flush(void)
+{
+    if (fd == -1) return;
+    if (fd >= 0)
+        for (int done = 0; done < buf.size(); ){
+            int n = ::write(fd, (uchar*)buf + done, buf.size() - done);
+            if (n <= 0) break;
+            done += n; }
+    bytes += buf.size();
+    buf.clear();
+}
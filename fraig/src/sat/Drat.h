@@ -0,0 +1,77 @@
+/*****************************************************************************************[Drat.h]
+MiniSat -- Copyright (c) 2003-2005, Niklas Een, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Drat_h
+#define Drat_h
+
+#include "SolverTypes.h"
+
+
+//=================================================================================================
+// DratWriter -- streams a binary DRAT proof (clause additions and deletions):
+//
+// Unlike 'Proof', nothing is kept for offline replay: every event is encoded at once ('a' or 'd',
+// the literals as 7-bit variable-length integers '2*(var+1)+sign', then 0) into a buffer that is
+// either written to a file whenever it fills up, or kept in memory as the proof itself.
+// The proof refers to the clauses given to the solver; writing those out is up to the caller.
+
+
+#define Drat_BufSize (1 << 20)
+
+class DratWriter {
+    int         fd;         // Output file, or -1 in memory mode.
+    vec<uchar>  buf;        // Write buffer (file mode), or the complete proof (memory mode).
+    int64       bytes;      // Bytes produced so far.
+
+    void putByte(int b) {
+        if (buf.size() == Drat_BufSize && fd != -1) flush();
+        buf.push((uchar)b); }
+
+    void putLit(Lit p) {
+        uint u = 2*(var(p)+1) + (uint)sign(p);
+        while (u > 127){ putByte(128 | (u & 127)); u >>= 7; }
+        putByte(u); }
+
+    template<class C>
+    void put(int type, const C& c) {
+        putByte(type);
+        for (int i = 0; i < c.size(); i++) putLit(c[i]);
+        putByte(0); }
+
+public:
+    DratWriter(void);               // Memory mode -- the proof is available from 'data()'.
+    DratWriter(cchar* filename);    // File mode.
+   ~DratWriter(void);
+
+    // Statistics: (read-only member variables)
+    //
+    int64   added, deleted;
+
+    template<class C> void add   (const C& c) { added++;   put('a', c); }   // 'C' is 'vec<Lit>' or 'Clause'.
+    template<class C> void remove(const C& c) { deleted++; put('d', c); }
+
+    bool    fail (void) const { return fd == -2; }          // TRUE if the output file could not be opened.
+    int64   size (void) const { return bytes + buf.size(); }
+    const vec<uchar>& data(void) const { assert(fd == -1); return buf; }
+    void    flush(void);
+};
+
+
+//=================================================================================================
+#endif
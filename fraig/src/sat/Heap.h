@@ -22,77 +22,138 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 
 //=================================================================================================
-
-
-static inline int left  (int i) { return i+i; }
-static inline int right (int i) { return i+i + 1; }
-static inline int parent(int i) { return i >> 1; }
-
-template<class C>
+// Heap -- a 'D'-ary min-heap of small non-negative integers (typically variables):
+//
+// The heap is stored 0-based in 'heap[]', with the children of node 'i' at 'D*i+1 .. D*i+D'. Each
+// entry caches the key of its element ('comp.key(n)'), so percolating compares keys that sit next
+// to each other in memory instead of chasing 'n' into an external table. With 4 children of 16
+// bytes, the children of a node fill one cache line and the tree is half as deep as a binary one.
+// 'indices[n]' is the position of 'n' in 'heap[]', or -1 if 'n' is not in the heap.
+//
+// The comparator 'C' provides 'Key', 'Key key(int n)' and 'bool operator () (Key x, Key y)'. A
+// cached key is refreshed whenever its element is inserted or 'increase()'d; if the keys change
+// in some other way (e.g. all are rescaled), call 'refresh()'.
+
+
+template<class C, int D = 4>
 class Heap {
   public:
-    C        comp;
-    vec<int> heap;     // heap of ints
-    vec<int> indices;  // int -> index in heap
+    typedef typename C::Key Key;
+    struct Elem { Key key; int n; };
+
+    C         comp;
+    vec<Elem> heap;     // heap of (key, int)
+    vec<int>  indices;  // int -> index in heap (-1 if not present)
+
+    static inline int firstChild(int i) { return D*i + 1; }
+    static inline int parent    (int i) { return (i - 1) / D; }
 
     inline void percolateUp(int i)
     {
-        int x = heap[i];
-        while (parent(i) != 0 && comp(x,heap[parent(i)])){
-            heap[i]          = heap[parent(i)];
-            indices[heap[i]] = i;
-            i                = parent(i);
+        Elem x = heap[i];
+        while (i != 0 && comp(x.key,heap[parent(i)].key)){
+            heap[i]            = heap[parent(i)];
+            indices[heap[i].n] = i;
+            i                  = parent(i);
         }
-        heap   [i] = x;
-        indices[x] = i;
+        heap   [i]   = x;
+        indices[x.n] = i;
     }
 
     inline void percolateDown(int i)
     {
-        int x = heap[i];
-        while (left(i) < heap.size()){
-            int child = right(i) < heap.size() && comp(heap[right(i)],heap[left(i)]) ? right(i) : left(i);
-            if (!comp(heap[child],x)) break;
-            heap[i]          = heap[child];
-            indices[heap[i]] = i;
-            i                = child;
+        Elem x  = heap[i];
+        int  sz = heap.size();
+        for (;;){
+            int c0 = firstChild(i);
+            if (c0 >= sz) break;
+            int cn    = (c0 + D < sz) ? c0 + D : sz;
+            int child = c0;
+            for (int c = c0+1; c < cn; c++)
+                if (comp(heap[c].key,heap[child].key)) child = c;
+            if (!comp(heap[child].key,x.key)) break;
+            heap[i]            = heap[child];
+            indices[heap[i].n] = i;
+            i                  = child;
         }
-        heap   [i] = x;
-        indices[x] = i;
+        heap   [i]   = x;
+        indices[x.n] = i;
     }
 
     bool ok(int n) { return n >= 0 && n < (int)indices.size(); }
 
   public:
-    Heap(C c) : comp(c) { heap.push(-1); }
+    Heap(C c) : comp(c) { }
 
-    void setBounds (int size) { assert(size >= 0); indices.growTo(size,0); }
-    bool inHeap    (int n)    { assert(ok(n)); return indices[n] != 0; }
-    void increase  (int n)    { assert(ok(n)); assert(inHeap(n)); percolateUp(indices[n]); }
-    bool empty     ()         { return heap.size() == 1; }
+    void setBounds (int size) { assert(size >= 0); indices.growTo(size,-1); }
+    bool inHeap    (int n)    { assert(ok(n)); return indices[n] >= 0; }
+    void increase  (int n)    { assert(ok(n)); assert(inHeap(n)); heap[indices[n]].key = comp.key(n); percolateUp(indices[n]); }
+    bool empty     ()         { return heap.size() == 0; }
+    int  size      ()         { return heap.size(); }
 
     void insert(int n) {
         assert(ok(n));
         indices[n] = heap.size();
-        heap.push(n);
+        heap.push();
+        heap.last().key = comp.key(n);
+        heap.last().n   = n;
         percolateUp(indices[n]); }
 
+    void remove(int n) {
+        assert(ok(n)); assert(inHeap(n));
+        int  i     = indices[n];
+        Elem x     = heap.last();
+        indices[n] = -1;
+        heap.pop();
+        if (i < heap.size()){
+            heap[i]      = x;
+            indices[x.n] = i;
+            percolateUp(i);
+            percolateDown(indices[x.n]); } }
+
     int  getmin() {
-        int r            = heap[1];
-        heap[1]          = heap.last();
-        indices[heap[1]] = 1;
-        indices[r]       = 0;
+        int  r     = heap[0].n;
+        Elem x     = heap.last();
+        indices[r] = -1;
         heap.pop();
-        if (heap.size() > 1)
-            percolateDown(1);
+        if (heap.size() > 0){
+            heap[0]      = x;
+            indices[x.n] = 0;
+            percolateDown(0); }
         return r; }
 
+    // Insert all elements of 'ns' (skipping those already present) with one bottom-up heap
+    // construction, O(size) instead of O(|ns| log size). Worth it when 'ns' is large (restarts).
+    void insertAll(const vec<int>& ns) {
+        for (int i = 0; i < ns.size(); i++){
+            assert(ok(ns[i]));
+            if (inHeap(ns[i])) continue;
+            indices[ns[i]] = heap.size();
+            heap.push();
+            heap.last().key = comp.key(ns[i]);
+            heap.last().n   = ns[i]; }
+        heapify(); }
+
+    // Re-read all cached keys and restore the heap property.
+    void refresh() {
+        for (int i = 0; i < heap.size(); i++)
+            heap[i].key = comp.key(heap[i].n);
+        heapify(); }
+
+    void heapify() {
+        for (int i = parent(heap.size() - 1); heap.size() > 1 && i >= 0; i--)
+            percolateDown(i); }
+
     bool heapProperty() {
-        return heapProperty(1); }
+        return heapProperty(0); }
 
     bool heapProperty(int i) {
-        return (size_t)i >= heap.size()
-            || ((parent(i) == 0 || !comp(heap[i],heap[parent(i)])) && heapProperty(left(i)) && heapProperty(right(i))); }
+        if (i >= heap.size()) return true;
+        if (heap[i].key != comp.key(heap[i].n)) return false;
+        if (i != 0 && comp(heap[i].key,heap[parent(i)].key)) return false;
+        for (int c = firstChild(i); c < firstChild(i) + D; c++)
+            if (!heapProperty(c)) return false;
+        return true; }
 };
 
 
@@ -0,0 +1,419 @@
+/**********************************************************************************[SimpSolver.C]
+MiniSat -- Copyright (c) 2003-2005, Niklas Een, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "SimpSolver.h"
+#include "Sort.h"
+
+
+//=================================================================================================
+// Helper functions:
+
+
+static inline uint abstractVars(const vec<Lit>& ps)
+{
+    uint abst = 0;
+    for (int i = 0; i < ps.size(); i++)
+        abst |= 1 << (var(ps[i]) & 31);
+    return abst;
+}
+
+
+// Returns 'lit_Undef' if 'c' subsumes 'd', 'lit_Error' if it does not, or a literal 'p' of 'c' such
+// that 'c' subsumes 'd' once 'p' is flipped (then '~p' can be removed from 'd').
+//
+static Lit subsumes(const vec<Lit>& c, const vec<Lit>& d)
+{
+    Lit ret = lit_Undef;
+    for (int i = 0; i < c.size(); i++){
+        for (int j = 0; j < d.size(); j++)
+            if (c[i] == d[j])
+                goto Found;
+            else if (ret == lit_Undef && c[i] == ~d[j]){
+                ret = c[i];
+                goto Found; }
+        return lit_Error;
+      Found:;
+    }
+    return ret;
+}
+
+
+struct elimCost_lt {
+    const vec<vec<int> >& occ;
+    elimCost_lt(const vec<vec<int> >& o) : occ(o) { }
+    bool operator () (Var x, Var y) { return occ[x].size() < occ[y].size(); }
+};
+
+
+//=================================================================================================
+// Operations on the working clause set:
+
+
+int SimpSolver::addElimClause(const vec<Lit>& ps)
+{
+    assert(ps.size() >= 2);
+    int ci = elim_cls.size();
+    elim_cls.push();
+    ps.copyTo(elim_cls.last());
+    elim_dead  .push(0);
+    elim_abst  .push(abstractVars(ps));
+    elim_queued.push(1);
+    elim_queue .push(ci);
+    for (int i = 0; i < ps.size(); i++)
+        elim_occ[var(ps[i])].push(ci);
+    return ci;
+}
+
+
+// NOTE! Occurrence lists are not updated; stale entries are skipped by their users. Satisfied
+// clauses stay in the DRAT proof: they may be the reasons of top-level assignments there.
+//
+void SimpSolver::removeElimClause(int ci)
+{
+    if (drat != NULL && !satisfied(elim_cls[ci])) drat->remove(elim_cls[ci]);
+    elim_dead[ci] = 1;
+    elim_cls[ci].clear(true);
+}
+
+
+// Removes 'l' from clause 'ci'. A clause that becomes unit is removed and its literal enqueued
+// (but not propagated). Returns FALSE on a top-level conflict.
+//
+bool SimpSolver::strengthen(int ci, Lit l)
+{
+    vec<Lit>& c = elim_cls[ci];
+    if (drat != NULL) c.copyTo(elim_tmp);
+    int i, j;
+    for (i = j = 0; i < c.size(); i++)
+        if (c[i] != l)
+            c[j++] = c[i];
+    c.shrink(i - j);
+    simp_stats.strengthened_clauses++;
+    if (drat != NULL){ drat->add(c); drat->remove(elim_tmp); }
+
+    if (c.size() == 1){
+        Lit unit = c[0];
+        removeElimClause(ci);
+        if (!enqueue(unit))
+            return ok = false;
+    }else{
+        elim_abst[ci] = abstractVars(c);
+        if (!elim_queued[ci]){
+            elim_queued[ci] = 1;
+            elim_queue.push(ci); }
+    }
+    return true;
+}
+
+
+// Propagates the top-level assignments made since the last call through the occurrence lists.
+//
+bool SimpSolver::propagateOcc()
+{
+    while (elim_qhead < trail.size()){
+        Lit        p  = trail[elim_qhead++];
+        vec<int>&  os = elim_occ[var(p)];
+        for (int i = 0; i < os.size(); i++){
+            int ci = os[i];
+            if (elim_dead[ci]) continue;
+            vec<Lit>& c = elim_cls[ci];
+            for (int k = 0; k < c.size(); k++)
+                if (c[k] == p){
+                    removeElimClause(ci);
+                    break;
+                }else if (c[k] == ~p){
+                    if (!strengthen(ci, ~p)) return false;
+                    break; }
+        }
+        os.clear(true);
+    }
+    return true;
+}
+
+
+// Removes clauses subsumed by the queued ones and strengthens clauses by self-subsuming resolution.
+//
+bool SimpSolver::backwardSubsume()
+{
+    while (elim_queue.size() > 0){
+        int ci = elim_queue.last();
+        elim_queue.pop();
+        elim_queued[ci] = 0;
+        if (elim_dead[ci]) continue;
+
+        // Only the clauses sharing the least frequent variable of 'ci' need to be checked:
+        const vec<Lit>& c = elim_cls[ci];
+        Var best = var(c[0]);
+        for (int k = 1; k < c.size(); k++)
+            if (elim_occ[var(c[k])].size() < elim_occ[best].size())
+                best = var(c[k]);
+
+        vec<int>& os = elim_occ[best];
+        for (int i = 0; i < os.size() && !elim_dead[ci]; i++){
+            int cj = os[i];
+            if (cj == ci || elim_dead[cj]) continue;
+            if (elim_cls[cj].size() < c.size() || (elim_abst[ci] & ~elim_abst[cj]) != 0) continue;
+
+            Lit l = subsumes(c, elim_cls[cj]);
+            if (l == lit_Undef){
+                removeElimClause(cj);
+                simp_stats.subsumed_clauses++;
+            }else if (l != lit_Error){
+                if (!strengthen(cj, ~l)) return false; }
+        }
+        if (!propagateOcc()) return false;
+    }
+    return true;
+}
+
+
+// Resolves 'ps' and 'qs' on 'v'. Returns FALSE if the resolvent is a tautology.
+//
+bool SimpSolver::merge(const vec<Lit>& ps, const vec<Lit>& qs, Var v, vec<Lit>& out)
+{
+    out.clear();
+    const vec<Lit>& big   = ps.size() < qs.size() ? qs : ps;
+    const vec<Lit>& small = ps.size() < qs.size() ? ps : qs;
+
+    for (int i = 0; i < small.size(); i++){
+        if (var(small[i]) == v) continue;
+        for (int j = 0; j < big.size(); j++)
+            if (var(big[j]) == var(small[i])){
+                if (big[j] == ~small[i])
+                    return false;
+                goto Next; }
+        out.push(small[i]);
+      Next:;
+    }
+    for (int i = 0; i < big.size(); i++)
+        if (var(big[i]) != v)
+            out.push(big[i]);
+    return true;
+}
+
+
+// Stores a removed clause for 'extendModel()'. The literal of 'v' goes first and the size last.
+//
+void SimpSolver::pushElimClause(Var v, const vec<Lit>& ps)
+{
+    int first = elimclauses.size();
+    for (int i = 0; i < ps.size(); i++){
+        elimclauses.push(index(ps[i]));
+        if (var(ps[i]) == v){
+            elimclauses[i + first] = elimclauses[first];
+            elimclauses[first]     = index(ps[i]); }
+    }
+    elimclauses.push(ps.size());
+}
+
+
+// Replaces all clauses on 'v' by their resolvents if that does not grow the clause set.
+//
+bool SimpSolver::eliminateVar(Var v)
+{
+    vec<int> pos, neg;
+    vec<int>& os = elim_occ[v];
+    for (int i = 0; i < os.size(); i++){
+        int ci = os[i];
+        if (elim_dead[ci]) continue;
+        const vec<Lit>& c = elim_cls[ci];
+        for (int k = 0; k < c.size(); k++)
+            if (var(c[k]) == v){
+                if (sign(c[k])) neg.push(ci);
+                else            pos.push(ci);
+                break; }
+    }
+    if (pos.size() + neg.size() > occ_lim)
+        return true;
+
+    // Check the resolvents first (bail out as soon as the limits are exceeded):
+    vec<Lit>    resolvent;
+    vec<Lit>    res_lits;
+    vec<int>    res_size;
+    for (int i = 0; i < pos.size(); i++)
+        for (int j = 0; j < neg.size(); j++)
+            if (merge(elim_cls[pos[i]], elim_cls[neg[j]], v, resolvent)){
+                if (res_size.size() >= pos.size() + neg.size() + grow || resolvent.size() > clause_lim)
+                    return true;
+                for (int k = 0; k < resolvent.size(); k++)
+                    res_lits.push(resolvent[k]);
+                res_size.push(resolvent.size());
+            }
+
+    // (the resolvents must be in the proof before their antecedents are deleted)
+    if (drat != NULL)
+        for (int i = 0, k = 0; i < res_size.size(); k += res_size[i++]){
+            resolvent.clear();
+            for (int j = 0; j < res_size[i]; j++)
+                resolvent.push(res_lits[k + j]);
+            drat->add(resolvent); }
+
+    // Eliminate; keep the smaller side for model extension:
+    eliminated[v] = 1;
+    order.remove(v);
+    simp_stats.eliminated_vars++;
+
+    vec<int>& keep = pos.size() > neg.size() ? neg : pos;
+    for (int i = 0; i < keep.size(); i++)
+        pushElimClause(v, elim_cls[keep[i]]);
+    elimclauses.push(index(pos.size() > neg.size() ? Lit(v) : ~Lit(v)));
+    elimclauses.push(1);
+
+    for (int i = 0; i < pos.size(); i++) removeElimClause(pos[i]);
+    for (int i = 0; i < neg.size(); i++) removeElimClause(neg[i]);
+    os.clear(true);
+
+    // Add the resolvents:
+    for (int i = 0, k = 0; i < res_size.size(); k += res_size[i++]){
+        if (res_size[i] == 1){
+            if (!enqueue(res_lits[k]))
+                return ok = false;
+        }else{
+            resolvent.clear();
+            for (int j = 0; j < res_size[i]; j++)
+                resolvent.push(res_lits[k + j]);
+            addElimClause(resolvent);
+        }
+    }
+    return propagateOcc();
+}
+
+
+//=================================================================================================
+// Major methods:
+
+
+// Assigns the eliminated variables from the stored clauses, in reverse order of elimination.
+//
+void SimpSolver::extendModel()
+{
+    int i, j;
+    for (i = elimclauses.size()-1; i > 0; i -= j){
+        for (j = elimclauses[i--]; j > 1; j--, i--){
+            Lit p = toLit(elimclauses[i]);
+            if ((sign(p) ? ~model[var(p)] : model[var(p)]) != l_False)
+                goto Next;
+        }
+        {   Lit x = toLit(elimclauses[i]);
+            model[var(x)] = lbool(!sign(x)); }
+      Next:;
+    }
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  eliminate : [void]  ->  [bool]
+|
+|  Description:
+|    Preprocess the problem clauses SatELite-style: backward subsumption, self-subsuming
+|    resolution and bounded variable elimination. Learnt clauses are dropped. Frozen variables
+|    are never eliminated; no clause or assumption may refer to an eliminated variable afterwards.
+|    Must be called at decision level 0. Returns FALSE if the problem is found unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool SimpSolver::eliminate()
+{
+    if (!ok) return false;      // GUARD (public method)
+    assert(decisionLevel() == 0);
+    if (proof != NULL) return true;     // (resolution proofs cannot follow eliminated variables)
+
+    if (propagate() != NULL){
+        ok = false;
+        return false; }
+
+    // Detach everything; learnt clauses are simply dropped:
+    for (int i = 0; i < watches.size(); i++)
+        watches[i].clear();
+    for (int i = 0; i < learnts.size(); i++){
+        if (drat != NULL) drat->remove(*learnts[i]);
+        remove(learnts[i], true); }
+    learnts.clear();
+    stats.learnts_literals = 0;
+    for (int i = 0; i < trail.size(); i++)
+        reason[var(trail[i])] = NULL;
+
+    frozen    .growTo(nVars(), 0);
+    eliminated.growTo(nVars(), 0);
+    elim_occ  .growTo(nVars());
+    elim_qhead = trail.size();
+    simp_stats.clauses_before = clauses.size();
+
+    // Load the problem clauses into the working set without top-level assigned literals:
+    vec<Lit> ps;
+    for (int i = 0; i < clauses.size(); i++){
+        Clause& c   = *clauses[i];
+        bool    sat = false;
+        ps.clear();
+        for (int k = 0; k < c.size() && !sat; k++)
+            if (value(c[k]) == l_True)
+                sat = true;
+            else if (value(c[k]) == l_Undef)
+                ps.push(c[k]);
+        if (!sat) addElimClause(ps);
+        if (drat != NULL && !sat && ps.size() < c.size()){
+            drat->add(ps);
+            drat->remove(c); }
+        remove(clauses[i], true);
+    }
+    clauses.clear();
+    stats.clauses_literals = 0;
+
+    // Subsumption, then variable elimination with the cheapest variables first:
+    if (backwardSubsume()){
+        vec<Var> vs;
+        for (Var v = 0; v < nVars(); v++)
+            if (!frozen[v] && !eliminated[v] && value(v) == l_Undef)
+                vs.push(v);
+        sort(vs, elimCost_lt(elim_occ));
+
+        for (int i = 0; i < vs.size(); i++){
+            if (eliminated[vs[i]] || value(vs[i]) != l_Undef) continue;
+            if (!eliminateVar(vs[i]) || !backwardSubsume()) break;
+        }
+    }
+
+    // Re-attach the surviving clauses:
+    for (int i = 0; i < elim_cls.size() && ok; i++)
+        if (!elim_dead[i])
+            Solver::addClause(elim_cls[i]);
+    if (ok && propagate() != NULL)
+        ok = false;
+
+    elim_cls   .clear(true);
+    elim_dead  .clear(true);
+    elim_abst  .clear(true);
+    elim_occ   .clear(true);
+    elim_queue .clear(true);
+    elim_queued.clear(true);
+
+    simp_stats.clauses_after = clauses.size();
+    return ok;
+}
+
+
+bool SimpSolver::solve(const vec<Lit>& assumps)
+{
+    for (int i = 0; i < assumps.size(); i++)
+        assert(!isEliminated(var(assumps[i])));
+
+    bool result = Solver::solve(assumps);
+    if (result && elimclauses.size() > 0)
+        extendModel();
+    return result;
+}
@@ -0,0 +1,106 @@
+/************************************************************************************[SimpSolver.h]
+MiniSat -- Copyright (c) 2003-2005, Niklas Een, Niklas Sorensson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef SimpSolver_h
+#define SimpSolver_h
+
+#include "Solver.h"
+
+
+//=================================================================================================
+// SimpSolver -- a 'Solver' with SatELite-style CNF preprocessing:
+
+
+struct SimpStats {
+    int     eliminated_vars, subsumed_clauses, strengthened_clauses;
+    int     clauses_before, clauses_after;
+    SimpStats() : eliminated_vars(0), subsumed_clauses(0), strengthened_clauses(0)
+      , clauses_before(0), clauses_after(0) { }
+};
+
+
+class SimpSolver : public Solver {
+protected:
+    // Preprocessor state (only alive inside 'eliminate()'):
+    //
+    vec<vec<Lit> >      elim_cls;         // Working copy of the problem clauses. Literals are kept sorted.
+    vec<char>           elim_dead;        // 'elim_dead[ci]' is TRUE if clause 'ci' has been removed.
+    vec<uint>           elim_abst;        // 32-bit abstraction of the variables in each clause (for quick subsumption rejection).
+    vec<vec<int> >      elim_occ;         // 'elim_occ[var]' lists the clauses 'var' occurs in. May contain stale entries.
+    vec<int>            elim_queue;       // Clauses to be checked for backward subsumption.
+    vec<char>           elim_queued;      // 'elim_queued[ci]' is TRUE if 'ci' is in 'elim_queue'.
+    int                 elim_qhead;       // Head of the unit queue (index into 'trail[]').
+    vec<Lit>            elim_tmp;         // (used by 'strengthen()' for proof logging)
+
+    // Persistent state:
+    //
+    vec<char>           frozen;           // 'frozen[var]' is TRUE if 'var' must never be eliminated.
+    vec<char>           eliminated;       // 'eliminated[var]' is TRUE if 'var' has been eliminated.
+    vec<int>            elimclauses;      // Clauses removed by variable elimination; needed to extend the model.
+
+    // Main internal methods:
+    //
+    int     addElimClause    (const vec<Lit>& ps);
+    void    removeElimClause (int ci);
+    bool    strengthen       (int ci, Lit l);
+    bool    propagateOcc     ();
+    bool    backwardSubsume  ();
+    bool    merge            (const vec<Lit>& ps, const vec<Lit>& qs, Var v, vec<Lit>& out);
+    bool    eliminateVar     (Var v);
+    void    pushElimClause   (Var v, const vec<Lit>& ps);
+    void    extendModel      ();
+    bool    satisfied        (const vec<Lit>& ps) const {
+        for (int i = 0; i < ps.size(); i++) if (value(ps[i]) == l_True) return true;
+        return false; }
+
+public:
+    SimpSolver() : elim_qhead(0)
+                 , grow           (0)
+                 , clause_lim     (20)
+                 , occ_lim        (400)
+                 { }
+
+    // Statistics: (read-only member variable)
+    //
+    SimpStats   simp_stats;
+
+    // Mode of operation:
+    //
+    int     grow;           // Allow a variable elimination step to grow the clause database by this many clauses.
+    int     clause_lim;     // Do not produce resolvents longer than this.
+    int     occ_lim;        // Do not try to eliminate variables occurring in more clauses than this.
+
+    // Problem specification:
+    //
+    void    setFrozen    (Var v, bool b) { frozen.growTo(nVars(), 0); frozen[v] = (char)b; }
+    bool    isEliminated (Var v) const   { return v < eliminated.size() && eliminated[v]; }
+    void    addClause    (const vec<Lit>& ps, bool A = true) {
+        for (int i = 0; i < ps.size(); i++) assert(!isEliminated(var(ps[i])));
+        Solver::addClause(ps, A); }
+
+    // Solving:
+    //
+    bool    eliminate();    // Subsumption, self-subsuming resolution and bounded variable elimination.
+    bool    solve(const vec<Lit>& assumps);
+    bool    solve() { vec<Lit> tmp; return solve(tmp); }
+};
+
+
+//=================================================================================================
+#endif
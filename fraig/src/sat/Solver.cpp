@@ -91,7 +91,9 @@ void Solver::newClause(const vec<Lit>& ps_, bool learnt, ClauseId id , bool A)
                 if (proof != NULL) proof->resolve(unit_id[var(qs[i])], qs[i]);
         qs.shrink(i - j);
         if (proof != NULL) id = proof->endChain();
-    }
+        if (drat != NULL && i != j) drat->add(qs);
+    }else
+        if (drat != NULL) drat->add(ps_);
     const vec<Lit>& ps = learnt ? ps_ : qs; // 'ps' is now the (possibly) reduced vector of literals.
 
     if (ps.size() == 0){
@@ -154,6 +156,7 @@ void Solver::remove(Clause* c, bool just_dealloc)
         else             stats.clauses_literals -= c->size();
 
         if (proof != NULL) proof->deleted(c->id());
+        if (drat  != NULL) drat->remove(*c);
     }
 
     xfree(c);
@@ -682,6 +685,7 @@ lbool Solver::search(int nof_conflicts, int nof_learnts, const SearchParams& par
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
                 cancelUntil(root_level);
+                order.rebuild();
                 return l_Undef; }
 
             if (decisionLevel() == 0)
@@ -730,6 +734,7 @@ void Solver::varRescaleActivity()
     for (int i = 0; i < nVars(); i++)
         activity[i] *= 1e-100;
     var_inc *= 1e-100;
+    order.rescale();
 }
 
 
@@ -759,7 +764,9 @@ void Solver::claRescaleActivity()
 bool Solver::solve(const vec<Lit>& assumps)
 {
     simplifyDB();
-    if (!ok) return false;
+    if (!ok){
+        if (drat != NULL){ conflict.clear(); drat->add(conflict); }
+        return false; }
 
     SearchParams    params(default_params);
     double  nof_conflicts = 100;
@@ -781,11 +788,13 @@ bool Solver::solve(const vec<Lit>& assumps)
                 conflict.push(~p);
                 if (proof != NULL) conflict_id = unit_id[var(p)];
             }
+            if (drat != NULL) drat->add(conflict);
             cancelUntil(0);
             return false; }
         Clause* confl = propagate();
         if (confl != NULL){
             analyzeFinal(confl), assert(conflict.size() > 0);
+            if (drat != NULL) drat->add(conflict);
             cancelUntil(0);
             return false; }
     }
@@ -820,6 +829,7 @@ bool Solver::solve(const vec<Lit>& assumps)
         nof_learnts   *= 1.1;
 
 if ((int)stats.conflicts >= effLimit) {
+   if (status == l_False && drat != NULL) drat->add(conflict);
    cancelUntil(0);
    return status == l_True;
 }
@@ -829,6 +839,7 @@ if ((int)stats.conflicts >= effLimit) {
         reportf("===================================\n");
     }
 
+    if (status == l_False && drat != NULL) drat->add(conflict);
     cancelUntil(0);
     return status == l_True;
 }
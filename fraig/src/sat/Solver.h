@@ -23,6 +23,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "SolverTypes.h"
 #include "VarOrder.h"
 #include "Proof.h"
+#include "Drat.h"
 
 // Redfine if you want output to go somewhere else:
 #define reportf(format, args...) ( printf(format , ## args), fflush(stdout) )
@@ -135,6 +136,7 @@ public:
              , default_params   (SearchParams(0.95, 0.999, 0.02))
              , expensive_ccmin  (2)
              , proof            (NULL)
+             , drat             (NULL)
              , verbosity        (0)
              , progress_estimate(0)
              , conflict_id      (ClauseId_NULL)
@@ -174,6 +176,7 @@ public:
     SearchParams    default_params;     // Restart frequency etc.
     int             expensive_ccmin;    // Controls conflict clause minimization. TRUE by default.
     Proof*          proof;              // Set this directly after constructing 'Solver' to enable proof logging. Initialized to NULL.
+    DratWriter*     drat;               // Set this to stream a DRAT proof of all derived clauses (and deletions). Initialized to NULL.
     int             verbosity;          // Verbosity level. 0=silent, 1=some progress report, 2=everything
 
     // Problem specification:
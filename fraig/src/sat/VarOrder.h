@@ -28,8 +28,10 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 
 struct VarOrder_lt {
+    typedef double Key;
     const vec<double>&  activity;
-    bool operator () (Var x, Var y) { return activity[x] > activity[y]; }
+    Key  key         (Var x)        { return activity[x]; }
+    bool operator () (Key x, Key y) { return x > y; }
     VarOrder_lt(const vec<double>&  act) : activity(act) { }
 };
 
@@ -37,17 +39,27 @@ class VarOrder {
     const vec<char>&    assigns;     // var->val. Pointer to external assignment table.
 //    const vec<double>&  activity;    // var->act. Pointer to external activity table.
     Heap<VarOrder_lt>   heap;
+    vec<char>           removed;     // var->bool. TRUE if the variable must never be selected again.
+    vec<Var>            undone;      // Variables passed to 'undo()' but not yet put back into the heap.
     double              random_seed; // For the internal random number generator
 
 public:
     VarOrder(const vec<char>& ass, const vec<double>& act) :
 //        assigns(ass), activity(act), heap(VarOrder_lt(act)), random_seed(91648253)
         assigns(ass), heap(VarOrder_lt(act)), random_seed(91648253)
+        , rebuild_ratio(4)
         { }
 
+    // Mode of operation:
+    //
+    int     rebuild_ratio;  // 'select()' re-heapifies if more than 1/rebuild_ratio of the heap was undone (0 = never).
+
     inline void newVar(void);
     inline void update(Var x);                  // Called when variable increased in activity.
-    inline void undo(Var x);                    // Called when variable is unassigned and may be selected again.
+    inline void undo(Var x);                    // Called when variable is unassigned and may be selected again (deferred).
+    inline void remove(Var x);                  // Called when variable is eliminated and must never be selected.
+    inline void rescale(void);                  // Called when all activities have been rescaled.
+    inline void rebuild(void);                  // Puts the undone variables back with one re-heapify (after a restart).
     inline Var  select(double random_freq =.0); // Selects a new, unassigned variable (or 'var_Undef' if none exists).
 };
 
@@ -55,6 +67,7 @@ public:
 void VarOrder::newVar(void)
 {
     heap.setBounds(assigns.size());
+    removed.push(0);
     heap.insert(assigns.size()-1);
 }
 
@@ -66,19 +79,57 @@ void VarOrder::update(Var x)
 }
 
 
+// The heap is only updated by the next 'select()' (or 'rebuild()'), which then knows how many
+// variables came back at once.
 void VarOrder::undo(Var x)
 {
     if (!heap.inHeap(x))
-        heap.insert(x);
+        undone.push(x);
+}
+
+
+void VarOrder::remove(Var x)
+{
+    removed[x] = 1;
+    if (heap.inHeap(x))
+        heap.remove(x);
+}
+
+
+void VarOrder::rescale(void)
+{
+    heap.refresh();
+}
+
+
+void VarOrder::rebuild(void)
+{
+    int i, j;
+    for (i = j = 0; i < undone.size(); i++)
+        if (toLbool(assigns[undone[i]]) == l_Undef && !removed[undone[i]])
+            undone[j++] = undone[i];
+    undone.shrink(i - j);
+    heap.insertAll(undone);
+    undone.clear();
 }
 
 
 Var VarOrder::select(double random_var_freq)
 {
+    // Put back the undone variables:
+    if (undone.size() > 0){
+        if (rebuild_ratio > 0 && rebuild_ratio * undone.size() > heap.size())
+            rebuild();
+        else{
+            for (int i = 0; i < undone.size(); i++)
+                if (!heap.inHeap(undone[i]) && !removed[undone[i]])
+                    heap.insert(undone[i]);
+            undone.clear(); } }
+
     // Random decision:
     if (drand(random_seed) < random_var_freq && !heap.empty()){
         Var next = irand(random_seed,assigns.size());
-        if (toLbool(assigns[next]) == l_Undef)
+        if (toLbool(assigns[next]) == l_Undef && heap.inHeap(next))
             return next;
     }
 
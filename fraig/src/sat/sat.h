@@ -11,7 +11,9 @@
 
 #include <cassert>
 #include <iostream>
-#include "Solver.h"
+#include <fstream>
+#include <vector>
+#include "SimpSolver.h"
 
 using namespace std;
 
@@ -19,7 +21,7 @@ using namespace std;
 class SatSolver
 {
    public : 
-      SatSolver():_solver(0) { }
+      SatSolver():_solver(0), _record(false), _cnfCount(0) { }
       ~SatSolver() { }
 
       // Solver initialization and reset
@@ -29,8 +31,9 @@ class SatSolver
       }
       void reset() {
          if (_solver) delete _solver;
-         _solver = new Solver();
+         _solver = new SimpSolver();
          _assump.clear(); _curVar = 0;
+         _cnf.clear(); _cnfCount = 0;
       }
 
       // Constructing proof model
@@ -43,11 +46,11 @@ class SatSolver
          Lit la = fa? ~Lit(va): Lit(va);
          Lit lb = fb? ~Lit(vb): Lit(vb);
          lits.push(la); lits.push(~lf);
-         _solver->addClause(lits); lits.clear();
+         addClause(lits); lits.clear();
          lits.push(lb); lits.push(~lf);
-         _solver->addClause(lits); lits.clear();
+         addClause(lits); lits.clear();
          lits.push(~la); lits.push(~lb); lits.push(lf);
-         _solver->addClause(lits); lits.clear();
+         addClause(lits); lits.clear();
       }
       // fa/fb = true if it is inverted
       void addXorCNF(Var vf, Var va, bool fa, Var vb, bool fb) {
@@ -56,13 +59,58 @@ class SatSolver
          Lit la = fa? ~Lit(va): Lit(va);
          Lit lb = fb? ~Lit(vb): Lit(vb);
          lits.push(~la); lits.push( lb); lits.push( lf);
-         _solver->addClause(lits); lits.clear();
+         addClause(lits); lits.clear();
          lits.push( la); lits.push(~lb); lits.push( lf);
-         _solver->addClause(lits); lits.clear();
+         addClause(lits); lits.clear();
          lits.push( la); lits.push( lb); lits.push(~lf);
-         _solver->addClause(lits); lits.clear();
+         addClause(lits); lits.clear();
          lits.push(~la); lits.push(~lb); lits.push(~lf);
-         _solver->addClause(lits); lits.clear();
+         addClause(lits); lits.clear();
+      }
+      // va == vb (or va == !vb if fb is true)
+      void addEqCNF(Var va, Var vb, bool fb) {
+         vec<Lit> lits;
+         Lit la = Lit(va);
+         Lit lb = fb? ~Lit(vb): Lit(vb);
+         lits.push(~la); lits.push( lb);
+         addClause(lits); lits.clear();
+         lits.push( la); lits.push(~lb);
+         addClause(lits); lits.clear();
+      }
+      // Same as "addEqCNF()", for an equivalence the clauses so far imply
+      // (e.g. just proven by "assumpSolve()"); with a DRAT proof, the
+      // clauses go to it as lemmas instead of being recorded
+      void addEqLemma(Var va, Var vb, bool fb) {
+         vec<Lit> lits;
+         Lit la = Lit(va);
+         Lit lb = fb? ~Lit(vb): Lit(vb);
+         lits.push(~la); lits.push( lb);
+         addLemma(lits); lits.clear();
+         lits.push( la); lits.push(~lb);
+         addLemma(lits); lits.clear();
+      }
+
+      // CNF preprocessing (variable elimination and subsumption)
+      // Variables referred to afterwards (new clauses, assumptions
+      // or getValue()) must be frozen before calling "preprocess()"
+      void setFrozen(Var v, bool b = true) { _solver->setFrozen(v, b); }
+      bool preprocess() { return _solver->eliminate(); }
+      bool isEliminated(Var v) const { return _solver->isEliminated(v); }
+
+      // Streams a DRAT proof of every clause derived from now on (NULL to stop).
+      // The proof refers to the clauses added so far and later on; the caller
+      // must keep 'd' alive while it is set
+      void setDrat(DratWriter* d) { _solver->drat = d; }
+      // Records the clauses added from now on, for "writeCnf()" to write
+      // them in DIMACS; with a DRAT proof, call it before adding any
+      void recordCnf(bool b = true) { _record = b; }
+      bool writeCnf(const char* fileName) const {
+         ofstream ofs(fileName);
+         if (!ofs) return false;
+         ofs << "p cnf " << _curVar << " " << _cnfCount << endl;
+         for (size_t i = 0, n = _cnf.size(); i < n; i++)
+            ofs << _cnf[i] << (_cnf[i] ? " " : "\n");
+         return (bool)ofs;
       }
 
       // For incremental proof, use "assumeSolve()"
@@ -74,7 +122,9 @@ class SatSolver
 
       // For one time proof, use "solve"
       void assertProperty(Var prop, bool val) {
-         _solver->addUnit(val? Lit(prop): ~Lit(prop));
+         vec<Lit> lits;
+         lits.push(val? Lit(prop): ~Lit(prop));
+         addClause(lits);
       }
       bool solve() { _solver->solve(); return _solver->okay(); }
 
@@ -83,12 +133,31 @@ class SatSolver
       int getValue(Var v) const {
          return (_solver->modelValue(v)==l_True?1:
                 (_solver->modelValue(v)==l_False?0:-1)); }
-      void printStats() const { const_cast<Solver*>(_solver)->printStats(); }
+      void printStats() const { const_cast<SimpSolver*>(_solver)->printStats(); }
+      const SolverStats& getStats() const { return _solver->stats; }
+      const SimpStats& getSimpStats() const { return _solver->simp_stats; }
 
    private : 
-      Solver           *_solver;    // Pointer to a Minisat solver
+      SimpSolver       *_solver;    // Pointer to a Minisat solver
       Var               _curVar;    // Variable currently
       vec<Lit>          _assump;    // Assumption List for assumption solve
+      bool              _record;    // Whether the clauses are recorded
+      vector<int>       _cnf;       // DIMACS literals, each clause ended by 0
+      size_t            _cnfCount;  // #clauses in _cnf
+
+      void addClause(vec<Lit>& lits) {
+         if (_record) {
+            for (int i = 0; i < lits.size(); i++)
+               _cnf.push_back(sign(lits[i]) ? -(var(lits[i]) + 1) : var(lits[i]) + 1);
+            _cnf.push_back(0);
+            _cnfCount++;
+         }
+         _solver->addClause(lits);
+      }
+      void addLemma(vec<Lit>& lits) {
+         if (_solver->drat) _solver->drat->add(lits);
+         _solver->addClause(lits);
+      }
 };
 
 #endif  // SAT_H
@@ -0,0 +1 @@
+../Drat.cpp
\ No newline at end of file
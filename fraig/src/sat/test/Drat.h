@@ -0,0 +1 @@
+../Drat.h
\ No newline at end of file
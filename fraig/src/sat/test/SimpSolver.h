@@ -0,0 +1 @@
+../SimpSolver.h
\ No newline at end of file
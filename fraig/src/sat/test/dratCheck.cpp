@@ -0,0 +1,175 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+// Checks a binary DRAT proof against a DIMACS CNF, forward: every added
+// clause must follow from the clauses before it by unit propagation (RUP).
+// Deletions are skipped, which keeps more clauses and is still sound.
+//
+//    dratCheck <cnf file> <drat file>
+
+typedef vector<int> Clause;
+
+vector<Clause>          clauses;
+vector<vector<size_t> > watches;    // by literal index, clauses watching it
+vector<int>             units;
+vector<signed char>     value;      // by variable: 1, -1 or 0
+vector<int>             trail;
+bool                    hasEmpty = false;
+
+size_t litIdx(int l) { return 2 * (size_t)abs(l) + (l < 0); }
+int litValue(int l) { int v = value[abs(l)]; return l < 0 ? -v : v; }
+void assign(int l) { value[abs(l)] = (l < 0 ? -1 : 1); trail.push_back(l); }
+
+void
+growVars(int l)
+{
+   size_t v = abs(l);
+   if (v < value.size()) return;
+   value.resize(v + 1, 0);
+   watches.resize(2 * v + 2);
+}
+
+// a literal may be repeated, as in the CNF of an AIG with equal fanins;
+// it must not be watched twice
+void
+addClause(Clause& c)
+{
+   for (size_t i = 0; i < c.size(); i++) growVars(c[i]);
+   sort(c.begin(), c.end());
+   c.erase(unique(c.begin(), c.end()), c.end());
+   if (c.empty()) { hasEmpty = true; return; }
+   if (c.size() == 1) { units.push_back(c[0]); return; }
+   clauses.push_back(c);
+   watches[litIdx(-c[0])].push_back(clauses.size() - 1);
+   watches[litIdx(-c[1])].push_back(clauses.size() - 1);
+}
+
+// true on a conflict; the watches of the clauses are kept up to date
+bool
+propagate(size_t head)
+{
+   while (head < trail.size()) {
+      int p = trail[head++];
+      vector<size_t>& ws = watches[litIdx(p)];
+      size_t j = 0;
+      for (size_t i = 0; i < ws.size(); i++) {
+         Clause& c = clauses[ws[i]];
+         if (c[0] == -p) { c[0] = c[1]; c[1] = -p; }
+         // find another literal not false to watch
+         bool moved = false;
+         for (size_t k = 2; k < c.size(); k++)
+            if (litValue(c[k]) >= 0) {
+               c[1] = c[k]; c[k] = -p;
+               watches[litIdx(-c[1])].push_back(ws[i]);
+               moved = true;
+               break;
+            }
+         if (moved) continue;
+         ws[j++] = ws[i];
+         if (litValue(c[0]) < 0) {
+            for (i++; i < ws.size(); i++) ws[j++] = ws[i];
+            ws.resize(j);
+            return true;
+         }
+         if (litValue(c[0]) == 0) assign(c[0]);
+      }
+      ws.resize(j);
+   }
+   return false;
+}
+
+bool
+isRup(const Clause& c)
+{
+   if (hasEmpty) return true;
+   bool conflict = false;
+   for (size_t i = 0; i < c.size() && !conflict; i++) {
+      int v = litValue(c[i]);
+      if (v > 0) conflict = true;          // a tautology
+      else if (v == 0) assign(-c[i]);
+   }
+   for (size_t i = 0; i < units.size() && !conflict; i++) {
+      int v = litValue(units[i]);
+      if (v < 0) conflict = true;
+      else if (v == 0) assign(units[i]);
+   }
+   if (!conflict) conflict = propagate(0);
+   for (size_t i = 0; i < trail.size(); i++) value[abs(trail[i])] = 0;
+   trail.clear();
+   return conflict;
+}
+
+bool
+readCnf(const char* fileName)
+{
+   ifstream ifs(fileName);
+   if (!ifs) return false;
+   string token;
+   Clause c;
+   while (ifs >> token) {
+      if (token == "c") { getline(ifs, token); continue; }
+      if (token == "p") { ifs >> token >> token >> token; continue; }
+      int l = atoi(token.c_str());
+      if (l) c.push_back(l);
+      else { addClause(c); c.clear(); }
+   }
+   return true;
+}
+
+int
+main(int argc, char** argv)
+{
+   if (argc != 3) {
+      cerr << "Usage: dratCheck <cnf file> <drat file>" << endl;
+      return 2;
+   }
+   if (!readCnf(argv[1])) {
+      cerr << "Error: cannot open \"" << argv[1] << "\"!!" << endl;
+      return 2;
+   }
+   ifstream proof(argv[2], ios::binary);
+   if (!proof) {
+      cerr << "Error: cannot open \"" << argv[2] << "\"!!" << endl;
+      return 2;
+   }
+
+   size_t lemmas = 0, deleted = 0;
+   int type;
+   while ((type = proof.get()) != EOF) {
+      if (type != 'a' && type != 'd') {
+         cerr << "Error: bad proof item '" << (char)type << "'!!" << endl;
+         return 2;
+      }
+      Clause c;
+      for (;;) {
+         unsigned u = 0, shift = 0;
+         int b;
+         do {
+            if ((b = proof.get()) == EOF) {
+               cerr << "Error: truncated proof!!" << endl;
+               return 2;
+            }
+            u |= (unsigned)(b & 127) << shift;
+            shift += 7;
+         } while (b & 128);
+         if (!u) break;
+         c.push_back((u & 1) ? -(int)(u >> 1) : (int)(u >> 1));
+      }
+      if (type == 'd') { deleted++; continue; }
+      for (size_t i = 0; i < c.size(); i++) growVars(c[i]);
+      lemmas++;
+      if (!isRup(c)) {
+         cout << "DRAT: lemma #" << lemmas << " does not follow by unit propagation" << endl;
+         return 1;
+      }
+      addClause(c);
+   }
+   cout << "DRAT: " << lemmas << " lemmas checked, " << deleted << " deletions skipped"
+        << (hasEmpty ? "; the empty clause is derived" : "") << endl;
+   return 0;
+}
@@ -0,0 +1,188 @@
+// Micro-benchmarks for the decision heap (Heap.h / VarOrder.h)
+//
+// Usage: satBench <file.aag> [#queries]
+//
+// 1. Builds the proof model the way CirMgr::genProofModel() does (one var
+//    per gate in DFS order, addAigCNF() per AIG, constant gate asserted)
+//    and runs fraig-like incremental queries (XOR miter + assumption) on
+//    random gate pairs; reports decision throughput of the solver.
+// 2. Drives VarOrder alone with restart-like cycles (decide/propagate all,
+//    bump, cancel everything) and compares putting the undone variables
+//    back one by one with a single rebuild().
+//
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include "sat.h"
+
+using namespace std;
+
+struct AigNode
+{
+   AigNode(): _isAig(false), _mark(false), _var(0) { _in[0] = _in[1] = 0; }
+
+   bool       _isAig;
+   bool       _mark;
+   unsigned   _in[2];   // AIGER literals
+   Var        _var;
+};
+
+vector<AigNode>  nodes;
+vector<unsigned> outputs;
+vector<unsigned> dfsList;   // variable indices in DFS order (const and PIs first)
+
+static unsigned
+rnd(unsigned long long& seed)
+{
+   seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+   return (unsigned)(seed >> 33);
+}
+
+bool
+readAag(const char* fileName)
+{
+   ifstream ifs(fileName);
+   if (!ifs) { cerr << "Cannot open file \"" << fileName << "\"!!" << endl; return false; }
+   string header;
+   unsigned m, i, l, o, a;
+   ifs >> header >> m >> i >> l >> o >> a;
+   if (header != "aag") { cerr << "Not an ASCII AIGER file!!" << endl; return false; }
+   nodes.resize(m + 1);
+   for (unsigned k = 0; k < i; ++k) { unsigned lit; ifs >> lit; }
+   for (unsigned k = 0; k < l; ++k) { unsigned lit, nxt; ifs >> lit >> nxt; }
+   for (unsigned k = 0; k < o; ++k) { unsigned lit; ifs >> lit; outputs.push_back(lit); }
+   for (unsigned k = 0; k < a; ++k) {
+      unsigned lhs, r0, r1;
+      ifs >> lhs >> r0 >> r1;
+      AigNode& n = nodes[lhs / 2];
+      n._isAig = true; n._in[0] = r0; n._in[1] = r1;
+   }
+   return (bool)ifs;
+}
+
+void
+dfs(unsigned v)
+{
+   AigNode& n = nodes[v];
+   if (n._mark) return;
+   n._mark = true;
+   if (n._isAig) { dfs(n._in[0] / 2); dfs(n._in[1] / 2); }
+   dfsList.push_back(v);
+}
+
+void
+genProofModel(SatSolver& s)
+{
+   dfs(0);
+   for (size_t k = 0; k < outputs.size(); ++k) dfs(outputs[k] / 2);
+   for (size_t k = 0; k < dfsList.size(); ++k) {
+      AigNode& n = nodes[dfsList[k]];
+      n._var = s.newVar();
+      if (n._isAig)
+         s.addAigCNF(n._var, nodes[n._in[0] / 2]._var, n._in[0] & 1,
+                     nodes[n._in[1] / 2]._var, n._in[1] & 1);
+   }
+   s.assertProperty(nodes[0]._var, false);
+}
+
+void
+benchSolver(SatSolver& s, unsigned nQueries)
+{
+   vector<unsigned> aigs;
+   for (size_t k = 0; k < dfsList.size(); ++k)
+      if (nodes[dfsList[k]]._isAig) aigs.push_back(dfsList[k]);
+   if (aigs.size() < 2) { cout << "No AIG gates to query!!" << endl; return; }
+
+   unsigned long long seed = 1;
+   unsigned nSat = 0;
+   double start = cpuTime();
+   for (unsigned q = 0; q < nQueries; ++q) {
+      Var a = nodes[aigs[rnd(seed) % aigs.size()]]._var;
+      Var b = nodes[aigs[rnd(seed) % aigs.size()]]._var;
+      Var x = s.newVar();
+      s.addXorCNF(x, a, false, b, rnd(seed) & 1);
+      s.assumeRelease();
+      s.assumeProperty(x, true);
+      if (s.assumpSolve()) ++nSat;
+   }
+   double t = cpuTime() - start;
+   const SolverStats& st = s.getStats();
+   cout << "Solver  : " << nQueries << " queries (" << nSat << " SAT), "
+        << st.decisions << " decisions, " << st.conflicts << " conflicts, "
+        << setprecision(3) << t << " s";
+   if (t > 0) cout << ", " << (double)st.decisions / t / 1e6 << " M decisions/s";
+   cout << endl;
+}
+
+// Emulates the search loop: decide (each decision also "propagates" a few
+// random variables, which stay in the heap), bump some activities, then
+// backtrack to level 0 as in a restart
+double
+benchOrder(int nVars, int nRounds, bool bulk, int64& decisions)
+{
+   vec<char>   assigns;
+   vec<double> activity;
+   VarOrder    order(assigns, activity);
+   vec<Var>    trail;
+   for (int k = 0; k < nVars; ++k) {
+      assigns.push(toInt(l_Undef));
+      activity.push(0);
+      order.newVar();
+   }
+   order.rebuild_ratio = 0;
+
+   unsigned long long seed = 7;
+   double inc = 1;
+   decisions = 0;
+   double start = cpuTime();
+   for (int r = 0; r < nRounds; ++r) {
+      for (Var v; (v = order.select()) != var_Undef; ++decisions) {
+         assigns[v] = toInt(l_True);
+         trail.push(v);
+         for (int k = 0; k < 3; ++k) {
+            Var p = rnd(seed) % nVars;
+            if (toLbool(assigns[p]) != l_Undef) continue;
+            assigns[p] = toInt(l_False);
+            trail.push(p);
+         }
+      }
+      for (int k = 0; k < nVars / 16; ++k) {
+         Var v = rnd(seed) % nVars;
+         activity[v] += inc;
+         order.update(v);
+      }
+      inc *= 1.05;
+      for (int k = trail.size() - 1; k >= 0; --k) {
+         assigns[trail[k]] = toInt(l_Undef);
+         order.undo(trail[k]);
+      }
+      if (bulk) order.rebuild();
+      trail.clear();
+   }
+   return cpuTime() - start;
+}
+
+int
+main(int argc, char** argv)
+{
+   if (argc < 2) { cerr << "Usage: " << argv[0] << " <file.aag> [#queries]" << endl; return 1; }
+   unsigned nQueries = (argc > 2)? atoi(argv[2]) : 1000;
+   if (!readAag(argv[1])) return 1;
+
+   SatSolver solver;
+   solver.initialize();
+   genProofModel(solver);
+   cout << "Model   : " << dfsList.size() << " vars" << endl;
+   benchSolver(solver, nQueries);
+
+   int nRounds = 2000000 / (dfsList.size() + 1) + 1;
+   for (int bulk = 0; bulk < 2; ++bulk) {
+      int64 decisions;
+      double t = benchOrder(dfsList.size(), nRounds, bulk, decisions);
+      cout << (bulk? "rebuild : " : "insert  : ") << nRounds << " restarts, "
+           << decisions << " decisions, " << setprecision(3) << t << " s";
+      if (t > 0) cout << ", " << (double)decisions / t / 1e6 << " M decisions/s";
+      cout << endl;
+   }
+}
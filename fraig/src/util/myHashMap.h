@@ -123,6 +123,20 @@ public:
    void forceInsert(const HashKey& k, const HashData& d) {
       _buckets[bucketNum(k)].push_back(HashNode(k, d)); }
 
+   // return true if (k, d) is in the hash and removed
+   bool remove(const HashKey& k, const HashData& d) {
+      size_t b = bucketNum(k);
+      for (size_t i = 0, bn = _buckets[b].size(); i < bn; ++i) {
+         ADD_COLL_COUNT;
+         if (_buckets[b][i].first == k && _buckets[b][i].second == d) {
+            _buckets[b][i] = _buckets[b].back();
+            _buckets[b].pop_back();
+            return true;
+         }
+      }
+      return false;
+   }
+
    #ifdef HASHMAP_DEBUG
    unsigned getCollCount() const { return _coll_count; }
    void resetCollCount() const { _coll_count = 0; }
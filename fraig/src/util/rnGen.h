@@ -26,5 +26,20 @@ class RandomNumGen
       }
 };
 
+// with a state of its own, so that each thread can draw its own sequence
+class LocalRandomNumGen
+{
+   public:
+      LocalRandomNumGen(unsigned seed) {
+         _state[0] = 0x330E; _state[1] = seed; _state[2] = seed >> 16;
+      }
+      const int operator() (const int range) {
+         return int(range * (double(nrand48(_state)) / INT_MAX));
+      }
+
+   private:
+      unsigned short _state[3];
+};
+
 #endif // RN_GEN_H
 